@@ -0,0 +1,150 @@
+#include "quantflow/indicators/moving_average.hpp"
+#include "quantflow/indicators/momentum.hpp"
+#include "quantflow/indicators/volatility.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quantflow;
+using namespace quantflow::indicators;
+
+namespace {
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double max_difference(const std::vector<double>& a, const std::vector<double>& b) {
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        worst = std::max(worst, std::abs(a[i] - b[i]));
+    }
+    return worst;
+}
+
+void report(const std::string& name, size_t n, double streaming, double batch, double diff) {
+    std::cout << std::left << std::setw(16) << name << std::right
+              << std::setw(10) << streaming / n * 1e9
+              << std::setw(10) << batch / n * 1e9
+              << std::setw(9) << streaming / batch << "x"
+              << std::setw(14) << std::scientific << std::setprecision(1) << diff
+              << std::fixed << std::setprecision(2) << "\n";
+}
+
+// Streams the series through the Indicator interface, as a strategy's
+// per-bar loop does, then runs compute() on a fresh instance
+void compare(const std::string& name, const std::function<std::unique_ptr<Indicator>()>& make,
+             const std::vector<double>& series, size_t rounds) {
+    std::vector<double> streamed(series.size());
+    std::vector<double> batched(series.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        std::unique_ptr<Indicator> indicator = make();
+        for (size_t i = 0; i < series.size(); ++i) {
+            indicator->update(series[i]);
+            streamed[i] = indicator->value();
+        }
+    }
+    double streaming = seconds_since(start);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < rounds; ++r) {
+        std::unique_ptr<Indicator> indicator = make();
+        indicator->compute(series, batched);
+    }
+    double batch = seconds_since(start);
+
+    report(name, series.size() * rounds, streaming, batch, max_difference(streamed, batched));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+    size_t rounds = (argc > 2) ? std::stoul(argv[2]) : 5;
+
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> step(0.0, 0.5);
+    std::uniform_real_distribution<double> spread(0.0, 1.0);
+
+    std::vector<double> close(n), high(n), low(n);
+    double price = 100.0;
+    for (size_t i = 0; i < n; ++i) {
+        price = std::max(1.0, price + step(rng));
+        close[i] = price;
+        high[i] = price + spread(rng);
+        low[i] = price - spread(rng);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << n << " values x " << rounds << " rounds\n";
+    std::cout << std::left << std::setw(16) << "indicator" << std::right
+              << std::setw(10) << "stream" << std::setw(10) << "batch"
+              << std::setw(10) << "speedup" << std::setw(14) << "max diff" << "\n";
+    std::cout << std::left << std::setw(16) << "" << std::right
+              << std::setw(10) << "ns/val" << std::setw(10) << "ns/val" << "\n";
+
+    compare("SMA(20)", [] { return std::make_unique<SMA>(20); }, close, rounds);
+    compare("EMA(20)", [] { return std::make_unique<EMA>(20); }, close, rounds);
+    compare("RSI(14)", [] { return std::make_unique<RSI>(14); }, close, rounds);
+    compare("MACD", [] { return std::make_unique<MACD>(); }, close, rounds);
+    compare("BB(20) middle", [] { return std::make_unique<BollingerBands>(20); }, close, rounds);
+
+    // Bands, and ATR, have no single-value form; compare their full outputs
+    {
+        std::vector<double> s_upper(n), s_lower(n), b_middle(n), b_upper(n), b_lower(n);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            std::unique_ptr<BollingerBands> bands = std::make_unique<BollingerBands>(20);
+            Indicator* indicator = bands.get();
+            for (size_t i = 0; i < n; ++i) {
+                indicator->update(close[i]);
+                s_upper[i] = bands->upper_band();
+                s_lower[i] = bands->lower_band();
+            }
+        }
+        double streaming = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            BollingerBands bands(20);
+            bands.compute(close, b_middle, b_upper, b_lower);
+        }
+        double batch = seconds_since(start);
+        report("BB(20) bands", n * rounds, streaming, batch,
+               std::max(max_difference(s_upper, b_upper), max_difference(s_lower, b_lower)));
+    }
+    {
+        std::vector<double> streamed(n), batched(n);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            ATR atr(14);
+            for (size_t i = 0; i < n; ++i) {
+                Bar bar{};
+                bar.high = high[i];
+                bar.low = low[i];
+                bar.close = close[i];
+                atr.update_bar(bar);
+                streamed[i] = atr.value();
+            }
+        }
+        double streaming = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            ATR atr(14);
+            atr.compute(high, low, close, batched);
+        }
+        double batch = seconds_since(start);
+        report("ATR(14)", n * rounds, streaming, batch, max_difference(streamed, batched));
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "quantflow/execution/order_book.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace quantflow;
+using namespace quantflow::execution;
+
+// Replays a synthetic market-by-order stream (adds, cancels, partial
+// executions around a drifting mid) with a few own orders in the queue,
+// and reports throughput of the book operations. Orders the mid drifts
+// through or away from are cancelled, so the book stays uncrossed.
+int main(int argc, char** argv) {
+    size_t num_messages = (argc > 1) ? std::stoul(argv[1]) : 10000000;
+
+    OrderBookConfig config;
+    config.min_price = 0.0;
+    config.tick_size = 0.01;
+    config.num_levels = 1 << 16;
+    config.initial_orders = 1 << 20;
+    config.max_orders = 1 << 20;
+
+    LimitOrderBook book(config);
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::uniform_int_distribution<int> offset(1, 50);
+    std::uniform_int_distribution<uint64_t> size(1, 500);
+
+    // Pre-generate the stream so the timed loop measures only the book
+    struct Message {
+        int kind;       // 0 add, 1 cancel, 2 execute, 3 own add
+        OrderID id;
+        bool is_buy;
+        double price;
+        uint64_t quantity;
+    };
+
+    std::vector<Message> messages;
+    messages.reserve(num_messages);
+
+    // Resting orders by price in ticks, so those the mid leaves behind can
+    // be pulled: an order on the wrong side of the mid would cross, and one
+    // more than BAND ticks away would never trade again
+    constexpr int64_t BAND = 60;
+
+    struct Resting {
+        OrderID id;
+        std::multimap<int64_t, size_t>::iterator where;
+        bool is_buy;
+    };
+
+    std::vector<Resting> live;
+    live.reserve(config.max_orders);
+    std::multimap<int64_t, size_t> bids_at;
+    std::multimap<int64_t, size_t> asks_at;
+
+    auto pull = [&](size_t pick) {
+        messages.push_back({1, live[pick].id, false, 0.0, 0});
+        (live[pick].is_buy ? bids_at : asks_at).erase(live[pick].where);
+        live[pick] = live.back();
+        live[pick].where->second = pick;
+        live.pop_back();
+    };
+
+    OrderID next_id = 1;
+    double mid = 300.0;
+    int64_t mid_ticks = 30000;
+
+    while (messages.size() < num_messages) {
+        mid += (unit(rng) - 0.5) * 0.002;
+        int64_t ticks = std::llround(mid / config.tick_size);
+
+        if (ticks != mid_ticks) {
+            mid_ticks = ticks;
+            while (!bids_at.empty() && std::prev(bids_at.end())->first >= mid_ticks) {
+                pull(std::prev(bids_at.end())->second);
+            }
+            while (!bids_at.empty() && bids_at.begin()->first < mid_ticks - BAND) {
+                pull(bids_at.begin()->second);
+            }
+            while (!asks_at.empty() && asks_at.begin()->first <= mid_ticks) {
+                pull(asks_at.begin()->second);
+            }
+            while (!asks_at.empty() && std::prev(asks_at.end())->first > mid_ticks + BAND) {
+                pull(std::prev(asks_at.end())->second);
+            }
+        }
+
+        double r = unit(rng);
+
+        if (live.size() < 1000 || (r < 0.50 && live.size() < config.max_orders / 2)) {
+            bool is_buy = unit(rng) < 0.5;
+            int64_t price = is_buy ? mid_ticks - offset(rng) : mid_ticks + offset(rng);
+            int kind = (unit(rng) < 0.01) ? 3 : 0;
+            messages.push_back({kind, next_id, is_buy, price * config.tick_size, size(rng)});
+            auto where = (is_buy ? bids_at : asks_at).emplace(price, live.size());
+            live.push_back({next_id, where, is_buy});
+            ++next_id;
+        } else {
+            size_t pick = rng() % live.size();
+            if (r < 0.85) {
+                pull(pick);
+            } else {
+                messages.push_back({2, live[pick].id, false, 0.0, size(rng)});
+            }
+        }
+    }
+
+    std::vector<BookFill> fills;
+    fills.reserve(1024);
+    size_t own_fills = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (const Message& m : messages) {
+        switch (m.kind) {
+            case 0: book.add(m.id, m.is_buy, m.price, m.quantity); break;
+            case 1: book.cancel(m.id); break;
+            case 2: book.execute(m.id, m.quantity, fills); break;
+            case 3: book.add_own(m.id, m.is_buy, m.price, m.quantity, fills); break;
+        }
+        own_fills += fills.size();
+        fills.clear();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "Messages:       " << messages.size() << std::endl;
+    std::cout << "Elapsed:        " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+    std::cout << "Throughput:     " << std::setprecision(2)
+              << messages.size() / seconds / 1e6 << " M msg/s" << std::endl;
+    std::cout << "Per message:    " << std::setprecision(1)
+              << seconds * 1e9 / messages.size() << " ns" << std::endl;
+    std::cout << "Resting orders: " << book.num_orders() << std::endl;
+    std::cout << "Own fills:      " << own_fills << std::endl;
+    std::cout << "Best bid/ask:   " << std::setprecision(2)
+              << book.best_bid() << " / " << book.best_ask() << std::endl;
+
+    if (!(book.best_bid() < book.best_ask())) {
+        std::cerr << "Book ended crossed" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
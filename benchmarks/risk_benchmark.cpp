@@ -0,0 +1,113 @@
+#include "quantflow/risk/risk_manager.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace quantflow;
+using namespace quantflow::risk;
+
+// Measures the pre-trade check on a book of a few thousand symbols and a
+// few dozen strategies with every rule enabled. Orders are resolved to
+// indices up front, as a strategy would on its hot path.
+int main(int argc, char** argv) {
+    size_t num_checks = (argc > 1) ? std::stoul(argv[1]) : 5000000;
+    const size_t num_symbols = 3000;
+    const size_t num_strategies = 32;
+
+    RiskLimits limits;
+    limits.max_position_size = 50000.0;
+    limits.max_symbol_exposure = 200000.0;
+    limits.max_strategy_exposure = 5000000.0;
+    limits.max_portfolio_leverage = 4.0;
+
+    RiskManager manager(limits);
+
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> price(10.0, 500.0);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::vector<Symbol> symbols;
+    for (size_t i = 0; i < num_symbols; ++i) {
+        symbols.push_back("SYM" + std::to_string(i));
+        manager.mark(symbols.back(), price(rng));
+    }
+    std::vector<StrategyID> strategies;
+    for (size_t i = 0; i < num_strategies; ++i) {
+        strategies.push_back("STRAT" + std::to_string(i));
+    }
+
+    // Seed positions through fills
+    for (size_t i = 0; i < 5000; ++i) {
+        Fill fill{};
+        fill.symbol = symbols[rng() % num_symbols];
+        fill.side = (unit(rng) < 0.6) ? OrderSide::BUY : OrderSide::SELL;
+        fill.quantity = 1 + rng() % 20;
+        fill.price = price(rng);
+        manager.on_fill(fill, strategies[rng() % num_strategies]);
+    }
+    manager.exposure().set_cash(20000000.0);
+    manager.update_equity(20000000.0);
+
+    // A market order on a symbol with no mark has nothing to price it at
+    Order unpriced{};
+    unpriced.symbol = "UNMARKED";
+    unpriced.side = OrderSide::BUY;
+    unpriced.quantity = 1e9;
+    if (manager.check(unpriced) != RiskCheck::NO_PRICE) {
+        std::cerr << "Unpriced market order was not rejected" << std::endl;
+        return 1;
+    }
+
+    std::vector<RiskOrder> orders;
+    orders.reserve(1 << 16);
+    for (size_t i = 0; i < (1 << 16); ++i) {
+        Order order{};
+        order.symbol = symbols[rng() % num_symbols];
+        order.strategy_id = strategies[rng() % num_strategies];
+        order.side = (unit(rng) < 0.5) ? OrderSide::BUY : OrderSide::SELL;
+        order.quantity = 1 + rng() % 200;
+        order.price = price(rng);
+        order.stop_price = (unit(rng) < 0.5) ? order.price * 0.98 : 0.0;
+        orders.push_back(manager.make_order(order));
+    }
+
+    // Throughput over the whole run
+    size_t passed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_checks; ++i) {
+        passed += manager.check(orders[i & (orders.size() - 1)]) == RiskCheck::PASS;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double total_ns = std::chrono::duration<double, std::nano>(elapsed).count();
+
+    // Per-call latency distribution; timer overhead is measured and removed
+    const size_t samples = 200000;
+    std::vector<double> latencies(samples);
+    double overhead = 1e9;
+    for (size_t i = 0; i < 1000; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto t1 = std::chrono::steady_clock::now();
+        overhead = std::min(overhead, std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    for (size_t i = 0; i < samples; ++i) {
+        const RiskOrder& order = orders[(i * 7919) & (orders.size() - 1)];
+        auto t0 = std::chrono::steady_clock::now();
+        passed += manager.check(order) == RiskCheck::PASS;
+        auto t1 = std::chrono::steady_clock::now();
+        latencies[i] = std::max(0.0, std::chrono::duration<double, std::nano>(t1 - t0).count() - overhead);
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Checks:          " << num_checks << "\n";
+    std::cout << "Mean:            " << total_ns / num_checks << " ns/check\n";
+    std::cout << "Throughput:      " << num_checks / (total_ns / 1e9) / 1e6 << " M checks/s\n";
+    std::cout << "p50 / p99 / max: " << latencies[samples / 2] << " / "
+              << latencies[samples * 99 / 100] << " / " << latencies.back() << " ns\n";
+    std::cout << "Passed:          " << passed << "\n";
+    return 0;
+}
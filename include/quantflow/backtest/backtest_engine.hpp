@@ -1,10 +1,21 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/core/timer_wheel.hpp"
 #include "quantflow/strategy/strategy_base.hpp"
+#include "quantflow/data/bar_series.hpp"
+#include "quantflow/backtest/performance_analyzer.hpp"
+#include "quantflow/execution/fill_simulator.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include "quantflow/portfolio/lot_ledger.hpp"
+#include "quantflow/portfolio/portfolio_snapshot.hpp"
+#include "quantflow/utils/thread_pool.hpp"
 #include <memory>
 #include <vector>
 #include <map>
+#include <string>
+#include <istream>
+#include <ostream>
 
 namespace quantflow {
 namespace backtest {
@@ -13,8 +24,49 @@ struct BacktestConfig {
     double initial_cash = 100000.0;
     double commission_rate = 0.001;
     double slippage_bps = 5.0;
+    
+    // Max share of each bar's volume our fills may take (0 = unlimited)
+    double max_participation = 0.0;
     Timestamp start_time = 0;
     Timestamp end_time = 0;
+    
+    // Equity is sampled every N bars. Metrics are always computed online;
+    // the stored curve is optional and, with max_equity_points > 0, is
+    // thinned 2:1 (and its stride doubled) whenever it reaches the cap.
+    size_t equity_sample_interval = 1;
+    size_t max_equity_points = 0;
+    bool record_equity_curve = true;
+    
+    // The fill log keeps the first max_fills fills (0 = no cap, growing
+    // with turnover for the whole run); later ones are only counted.
+    // Metrics see every fill either way.
+    bool record_fills = true;
+    size_t max_fills = 100000;
+    
+    // Run strategies' on_bar concurrently on this many threads (<= 1 runs
+    // them on the calling thread). Order actions are buffered per strategy
+    // and merged in registration order, so results match the serial run.
+    size_t strategy_threads = 1;
+    
+    // Write a checkpoint to checkpoint_path every N bars (0 = never)
+    size_t checkpoint_interval = 0;
+    std::string checkpoint_path;
+    
+    // Tick of the timer wheel; timers still fire at their exact timestamp,
+    // this only sets how finely they are bucketed
+    Duration timer_resolution = 1000000;
+    
+    // Equity is updated from per-bar deltas; every N bars the position
+    // values are re-summed exactly to shed rounding drift (0 = never)
+    size_t equity_resync_interval = 4096;
+    
+    // Publish a lock-free portfolio snapshot every N bars for readers on
+    // other threads (0 = never); the slots hold this many symbols
+    size_t snapshot_interval = 0;
+    size_t snapshot_capacity = 4096;
+    
+    // Lot matching for realized P&L and entry prices
+    portfolio::LotMethod lot_method = portfolio::LotMethod::FIFO;
 };
 
 struct BacktestResult {
@@ -32,33 +84,169 @@ struct BacktestResult {
 class BacktestEngine : public strategy::StrategyContext {
 public:
     explicit BacktestEngine(const BacktestConfig& config);
+    ~BacktestEngine() override;
     
     void add_strategy(std::shared_ptr<strategy::Strategy> strategy);
     void add_data(const std::vector<Bar>& bars);
     
+    // Share a pre-sorted, read-only series with other engines (no copy)
+    void set_data(data::BarSeriesPtr series);
+    const data::BarSeriesPtr& get_data() const { return data_; }
+    
+    // Processes bars from the current cursor. A second call after new bars
+    // were appended (or after load_checkpoint) continues where it stopped.
     void run();
+    
+    // Binary snapshot of portfolio, open orders, bar cursor, metrics and
+    // recorded buffers, plus each strategy's opt-in save_state blob
+    void save_checkpoint(std::ostream& out) const;
+    void load_checkpoint(std::istream& in);
+    void save_checkpoint(const std::string& path) const;
+    void load_checkpoint(const std::string& path);
+    
+    size_t get_cursor() const { return cursor_; }
     BacktestResult get_results() const;
+    PerformanceMetrics get_metrics() const;
     
-    // StrategyContext interface
+    const std::vector<double>& get_equity_curve() const { return equity_curve_; }
+    
+    // Bars between stored curve points (sample interval times the stride
+    // thinning has reached), for PerformanceAnalyzer::calculate
+    size_t get_curve_interval() const { return sample_interval_ * curve_stride_; }
+    const std::vector<Fill>& get_fills() const { return fills_; }
+    uint64_t get_unrecorded_fills() const { return unrecorded_fills_; }
+    
+    // Positions as dense per-symbol arrays; get_portfolio() mirrors them
+    const portfolio::PositionBook& get_positions() const { return book_; }
+    const portfolio::LotLedger& get_lots() const { return lots_; }
+    
+    // Safe to read from any thread while run() is in progress
+    const portfolio::SnapshotPublisher& get_snapshots() const { return snapshots_; }
+    
+    // StrategyContext interface (direct, unbuffered access for callers
+    // outside strategy callbacks)
     OrderID buy(const Symbol& symbol, double quantity, double price = 0.0) override;
     OrderID sell(const Symbol& symbol, double quantity, double price = 0.0) override;
     void cancel_order(OrderID order_id) override;
+    OrderID submit_order(const strategy::OrderRequest& request) override;
+    std::vector<OrderID> submit_orders(const std::vector<strategy::OrderRequest>& requests) override;
+    void cancel_orders(const std::vector<OrderID>& order_ids) override;
+    std::vector<OrderID> rebalance(strategy::RebalanceUniverse& universe,
+                                   const std::vector<double>& weights) override;
+    
+    // Timers scheduled here are delivered to every strategy
+    TimerID schedule_timer(Timestamp when, uint64_t user_data = 0,
+                           Duration interval = 0) override;
+    void cancel_timer(TimerID timer_id) override;
     
     const Position* get_position(const Symbol& symbol) const override;
     const PortfolioState& get_portfolio() const override;
     double get_cash() const override;
 
 private:
+    // Context handed to each strategy. Reads go straight to the engine;
+    // order actions are queued and applied by merge_order_actions() once
+    // every strategy has finished the current callback round. Order IDs come
+    // from a per-strategy block so they do not depend on thread timing.
+    class StrategySlot : public strategy::StrategyContext {
+    public:
+        StrategySlot(BacktestEngine& engine, std::shared_ptr<strategy::Strategy> strategy,
+                     uint16_t block);
+        
+        OrderID buy(const Symbol& symbol, double quantity, double price = 0.0) override;
+        OrderID sell(const Symbol& symbol, double quantity, double price = 0.0) override;
+        void cancel_order(OrderID order_id) override;
+        OrderID submit_order(const strategy::OrderRequest& request) override;
+        std::vector<OrderID> submit_orders(const std::vector<strategy::OrderRequest>& requests) override;
+        void cancel_orders(const std::vector<OrderID>& order_ids) override;
+        std::vector<OrderID> rebalance(strategy::RebalanceUniverse& universe,
+                                       const std::vector<double>& weights) override;
+        
+        TimerID schedule_timer(Timestamp when, uint64_t user_data = 0,
+                               Duration interval = 0) override;
+        void cancel_timer(TimerID timer_id) override;
+        
+        const Position* get_position(const Symbol& symbol) const override;
+        const PortfolioState& get_portfolio() const override;
+        double get_cash() const override;
+        
+        struct Action {
+            Order order;        // submit when order.id != 0
+            OrderID cancel_id;  // otherwise cancel this id
+        };
+        
+        struct TimerAction {
+            TimerID id;
+            Timestamp when;
+            uint64_t user_data;
+            Duration interval;
+            bool cancel;
+        };
+        
+        BacktestEngine& engine;
+        std::shared_ptr<strategy::Strategy> strategy;
+        uint16_t block;
+        uint64_t next_sequence;
+        uint64_t next_timer_sequence;
+        std::vector<Action> actions;
+        std::vector<TimerAction> timer_actions;
+    };
+    
     BacktestConfig config_;
     PortfolioState portfolio_;
+    portfolio::PositionBook book_;      // owns positions; portfolio_ is its view
+    portfolio::LotLedger lots_;         // indexed like book_
+    portfolio::SnapshotPublisher snapshots_;
     std::vector<std::shared_ptr<strategy::Strategy>> strategies_;
-    std::vector<Bar> bars_;
+    std::vector<std::unique_ptr<StrategySlot>> slots_;
+    std::unique_ptr<utils::ThreadPool> pool_;
+    data::BarSeriesPtr data_;
     std::map<OrderID, Order> orders_;
+    std::vector<double> working_;       // signed open quantity, indexed (and sized) like book_
+    execution::FillSimulator fill_sim_;
+    std::vector<execution::SimulatedFill> pending_fills_;
     OrderID next_order_id_;
+    FillID next_fill_id_;
+    Timestamp current_time_;
+    
+    // Owner 0 broadcasts; otherwise the owning slot's block
+    TimerWheel timers_;
+    uint64_t next_timer_id_;
+    
+    size_t bars_since_resync_;
+    
+    StreamingPerformanceAnalyzer analyzer_;
+    std::vector<double> equity_curve_;
+    std::vector<Fill> fills_;
+    uint64_t unrecorded_fills_;     // fills past max_fills
+    size_t sample_interval_;
+    size_t bars_since_sample_;
+    size_t curve_stride_;
+    size_t samples_since_point_;
+    
+    size_t cursor_;
+    Timestamp cursor_timestamp_;
+    bool started_;
+    
+    static OrderID make_order_id(uint16_t block, uint64_t sequence);
+    static strategy::OrderRequest limit_or_market(const Symbol& symbol, OrderSide side,
+                                                  double quantity, double price);
+    static void validate_request(const strategy::OrderRequest& request);
+    Order make_order(OrderID id, const strategy::OrderRequest& request) const;
+    void merge_order_actions(const Bar* bar);
+    void submit_order(Order& order, const Bar* bar);
+    void add_working(const Order& order, double quantity);
+    void fire_timers(Timestamp now);
     
     void process_bar(const Bar& bar);
-    void execute_order(Order& order, double price);
+    void sample_equity();
+    void append_curve_point();
+    void resolve_cursor();
+    void apply_fills();
     void update_portfolio(const Bar& bar);
+    void publish_snapshot();
+    void plan_rebalance(strategy::RebalanceUniverse& universe, const std::vector<double>& weights,
+                        std::vector<strategy::OrderRequest>& orders) const;
 };
 
 } // namespace backtest
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/lot_ledger.hpp"
+#include "quantflow/utils/binary_io.hpp"
 #include <vector>
 #include <cmath>
 
@@ -29,23 +31,81 @@ struct PerformanceMetrics {
     double total_slippage;
 };
 
-class PerformanceAnalyzer {
+// Online metrics: O(1) work per observation and memory independent of run
+// length. Returns use Welford running moments; trades are scored on the
+// realized P&L the caller's lot accounting booked for each fill. The batch
+// PerformanceAnalyzer is built on top of this class.
+//
+// Bars are taken to be trading days. With one equity observation every
+// sample_interval bars, a year is TRADING_DAYS_PER_YEAR / sample_interval
+// periods; the risk-free rate and the annualization both use that.
+class StreamingPerformanceAnalyzer {
 public:
-    static PerformanceMetrics calculate(
-        const std::vector<double>& equity_curve,
-        const std::vector<Fill>& fills,
+    explicit StreamingPerformanceAnalyzer(
         double initial_capital,
-        double risk_free_rate = 0.02
+        double risk_free_rate = 0.02,
+        size_t sample_interval = 1
     );
     
+    void reset(double initial_capital);
+    
+    void add_equity(double equity);
+    // realized_pnl: what the fill closed, 0 for a fill that only opens
+    void add_fill(const Fill& fill, double realized_pnl);
+    
+    PerformanceMetrics metrics() const;
+    
+    void save_state(utils::BinaryWriter& out) const;
+    void load_state(utils::BinaryReader& in);
+    
+    size_t num_observations() const { return num_equity_; }
+    double last_equity() const { return last_equity_; }
+
 private:
-    static double calculate_sharpe_ratio(
-        const std::vector<double>& returns,
-        double risk_free_rate
-    );
+    double initial_capital_;
+    double risk_free_rate_;
+    size_t sample_interval_;
+    
+    double periods_per_year() const {
+        return static_cast<double>(constants::TRADING_DAYS_PER_YEAR) / sample_interval_;
+    }
     
-    static double calculate_max_drawdown(
-        const std::vector<double>& equity_curve
+    // Equity / returns
+    size_t num_equity_;
+    double last_equity_;
+    size_t num_returns_;
+    double mean_return_;
+    double m2_return_;
+    double downside_sq_sum_;
+    
+    // Drawdown
+    double peak_equity_;
+    size_t peak_index_;
+    double max_drawdown_;
+    size_t max_drawdown_duration_;
+    
+    // Trades
+    int total_fills_;
+    int winning_trades_;
+    int losing_trades_;
+    double total_wins_;
+    double total_losses_;
+    double total_commission_;
+    double total_slippage_;
+};
+
+class PerformanceAnalyzer {
+public:
+    // Fills are matched against open lots by lot_method, as in the engine.
+    // sample_interval is the number of bars between curve points; for an
+    // engine's curve that is BacktestEngine::get_curve_interval().
+    static PerformanceMetrics calculate(
+        const std::vector<double>& equity_curve,
+        const std::vector<Fill>& fills,
+        double initial_capital,
+        double risk_free_rate = 0.02,
+        portfolio::LotMethod lot_method = portfolio::LotMethod::FIFO,
+        size_t sample_interval = 1
     );
 };
 
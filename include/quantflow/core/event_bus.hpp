@@ -0,0 +1,170 @@
+#pragma once
+
+#include "types.hpp"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace quantflow {
+
+// Payload type carried by each EventType
+template<EventType Type> struct EventTraits;
+
+template<> struct EventTraits<EventType::TICK> { using Payload = Tick; };
+template<> struct EventTraits<EventType::BAR> { using Payload = Bar; };
+template<> struct EventTraits<EventType::ORDER_BOOK> { using Payload = OrderBook; };
+template<> struct EventTraits<EventType::ORDER_UPDATE> { using Payload = Order; };
+template<> struct EventTraits<EventType::FILL> { using Payload = Fill; };
+template<> struct EventTraits<EventType::POSITION_UPDATE> { using Payload = Position; };
+template<> struct EventTraits<EventType::TIMER> { using Payload = TimerEvent; };
+template<> struct EventTraits<EventType::SYSTEM> { using Payload = SystemEvent; };
+
+template<EventType Type>
+using EventPayload = typename EventTraits<Type>::Payload;
+
+// Reverse mapping: payload type -> EventType
+template<typename Payload> struct PayloadTraits;
+
+template<> struct PayloadTraits<Tick> { static constexpr EventType type = EventType::TICK; };
+template<> struct PayloadTraits<Bar> { static constexpr EventType type = EventType::BAR; };
+template<> struct PayloadTraits<OrderBook> { static constexpr EventType type = EventType::ORDER_BOOK; };
+template<> struct PayloadTraits<Order> { static constexpr EventType type = EventType::ORDER_UPDATE; };
+template<> struct PayloadTraits<Fill> { static constexpr EventType type = EventType::FILL; };
+template<> struct PayloadTraits<Position> { static constexpr EventType type = EventType::POSITION_UPDATE; };
+template<> struct PayloadTraits<TimerEvent> { static constexpr EventType type = EventType::TIMER; };
+template<> struct PayloadTraits<SystemEvent> { static constexpr EventType type = EventType::SYSTEM; };
+
+template<typename Payload, typename = void>
+struct is_event_payload : std::false_type {};
+
+template<typename Payload>
+struct is_event_payload<Payload, std::void_t<decltype(PayloadTraits<Payload>::type)>>
+    : std::true_type {};
+
+template<typename Payload>
+inline constexpr bool is_event_payload_v = is_event_payload<Payload>::value;
+
+// True when Handler has an on_event overload accepting Payload
+template<typename Handler, typename Payload, typename = void>
+struct handles_event : std::false_type {};
+
+template<typename Handler, typename Payload>
+struct handles_event<Handler, Payload, std::void_t<
+    decltype(std::declval<Handler&>().on_event(std::declval<const Payload&>()))>>
+    : std::true_type {};
+
+template<typename Handler, typename Payload>
+inline constexpr bool handles_event_v = handles_event<Handler, Payload>::value;
+
+// Event bus over a fixed set of handler types. A handler subscribes to an
+// event type simply by declaring on_event(const Payload&); every handler
+// that does is called, in template argument order, with no type erasure or
+// indirect call. The bus references handlers, it does not own them.
+//
+// publish() delivers immediately. post() copy-assigns the payload into a
+// per-type queue whose slots are kept between drains, so the strings and
+// vectors inside OrderBook, Order and Fill payloads reuse their buffers.
+// Queuing is allocation-free once the queues have reached their working
+// depth and no payload outgrows the slot it lands in; POD payloads only
+// need the depth.
+template<typename... Handlers>
+class EventBus {
+public:
+    explicit EventBus(Handlers&... handlers) : handlers_(handlers...) {}
+
+    template<typename Payload>
+    void publish(const Payload& event) {
+        static_assert(is_event_payload_v<Payload>, "Not an event payload type");
+        std::apply([&event](auto&... handler) {
+            (deliver(handler, event), ...);
+        }, handlers_);
+    }
+
+    template<typename Payload>
+    void post(const Payload& event) {
+        static_assert(is_event_payload_v<Payload>, "Not an event payload type");
+        queue<Payload>().push(event);
+        order_.push_back(PayloadTraits<Payload>::type);
+    }
+
+    // Delivers queued events in post order. Events posted by handlers while
+    // draining are delivered in the same call.
+    void drain() {
+        for (size_t i = 0; i < order_.size(); ++i) {
+            switch (order_[i]) {
+                case EventType::TICK: deliver_next<Tick>(); break;
+                case EventType::BAR: deliver_next<Bar>(); break;
+                case EventType::ORDER_BOOK: deliver_next<OrderBook>(); break;
+                case EventType::ORDER_UPDATE: deliver_next<Order>(); break;
+                case EventType::FILL: deliver_next<Fill>(); break;
+                case EventType::POSITION_UPDATE: deliver_next<Position>(); break;
+                case EventType::TIMER: deliver_next<TimerEvent>(); break;
+                case EventType::SYSTEM: deliver_next<SystemEvent>(); break;
+            }
+        }
+
+        order_.clear();
+        std::apply([](auto&... q) { (q.clear(), ...); }, queues_);
+    }
+
+    size_t pending() const { return order_.size(); }
+
+    template<typename Payload>
+    static constexpr size_t num_subscribers() {
+        return (size_t{0} + ... + (handles_event_v<Handlers, Payload> ? 1 : 0));
+    }
+
+private:
+    template<typename Payload>
+    struct Queue {
+        std::vector<Payload> items;     // slots past size hold spent payloads
+        size_t size = 0;
+        size_t head = 0;
+        Payload current{};              // the event being delivered
+
+        void push(const Payload& event) {
+            if (size < items.size()) {
+                items[size] = event;
+            } else {
+                items.push_back(event);
+            }
+            ++size;
+        }
+
+        void clear() {
+            size = 0;
+            head = 0;
+        }
+    };
+
+    std::tuple<Handlers&...> handlers_;
+    std::tuple<
+        Queue<Tick>, Queue<Bar>, Queue<OrderBook>, Queue<Order>,
+        Queue<Fill>, Queue<Position>, Queue<TimerEvent>, Queue<SystemEvent>
+    > queues_;
+    std::vector<EventType> order_;
+
+    template<typename Handler, typename Payload>
+    static void deliver(Handler& handler, const Payload& event) {
+        if constexpr (handles_event_v<Handler, Payload>) {
+            handler.on_event(event);
+        }
+    }
+
+    template<typename Payload>
+    Queue<Payload>& queue() {
+        return std::get<Queue<Payload>>(queues_);
+    }
+
+    template<typename Payload>
+    void deliver_next() {
+        auto& q = queue<Payload>();
+        // Swap out: a handler may post and reallocate the same queue. The
+        // slot takes the previous event's buffers for its next reuse.
+        std::swap(q.current, q.items[q.head++]);
+        publish(q.current);
+    }
+};
+
+} // namespace quantflow
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "types.hpp"
+#include "quantflow/utils/binary_io.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+
+// A timer that has come due, as returned by TimerWheel::pop_due
+struct DueTimer {
+    TimerID id;
+    Timestamp when;
+    uint64_t user_data;
+    uint32_t owner;
+};
+
+// Hierarchical timing wheel: four levels of 256 slots over ticks of
+// `resolution` nanoseconds (2^32 ticks, ~50 days at 1 ms), plus an overflow
+// list for anything further out. A timer sits in the level of the highest
+// tick byte in which it differs from the wheel's current tick, and moves
+// down a level each time the wheel reaches its slot.
+//
+// schedule and cancel are O(1). Advancing skips empty slots with a bitmap
+// per level, so the cost of a pop_due call that finds nothing due does not
+// depend on the number of timers or on how far time moves. Due timers are
+// returned in (when, schedule order), at nanosecond precision.
+//
+// IDs are chosen by the caller and must be non-zero and unique among
+// pending timers.
+class TimerWheel {
+public:
+    explicit TimerWheel(Timestamp resolution = 1000000);
+
+    // Fires at `when` and, with interval > 0, every interval after that
+    bool schedule(TimerID id, Timestamp when, uint64_t user_data = 0,
+                  Duration interval = 0, uint32_t owner = 0);
+    bool cancel(TimerID id);
+
+    // Removes and returns the earliest timer due at or before `now`.
+    // Periodic timers are re-armed before they are returned.
+    bool pop_due(Timestamp now, DueTimer& out);
+
+    bool contains(TimerID id) const { return index_.count(id) != 0; }
+    size_t size() const { return index_.size(); }
+    bool empty() const { return index_.empty(); }
+    void clear();
+
+    // Pending timers with their IDs and tie-break order
+    void save_state(utils::BinaryWriter& out) const;
+    void load_state(utils::BinaryReader& in);
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr int OVERFLOW_LIST = LEVELS;
+
+    enum class State : uint8_t { FREE, LISTED, READY, CANCELLED };
+
+    struct Node {
+        TimerID id;
+        Timestamp when;
+        Duration interval;
+        uint64_t user_data;
+        uint64_t sequence;
+        uint64_t tick;
+        uint32_t owner;
+        uint32_t prev;
+        uint32_t next;
+        uint8_t level;      // list the node is in; OVERFLOW_LIST for overflow
+        uint8_t slot;
+        State state;
+    };
+
+    Timestamp resolution_;
+    uint64_t now_tick_;
+    uint64_t next_sequence_;
+
+    std::vector<Node> nodes_;
+    uint32_t free_head_;
+    std::unordered_map<TimerID, uint32_t> index_;
+
+    uint32_t heads_[LEVELS + 1][SLOTS];
+    uint64_t occupied_[LEVELS][SLOTS / 64];
+    size_t listed_;                         // nodes in levels or overflow
+    size_t overflow_size_;
+
+    // Due in the current tick, min-heap on (when, sequence)
+    std::vector<uint32_t> ready_;
+
+    uint64_t to_tick(Timestamp when) const;
+    uint32_t allocate();
+    void release(uint32_t n);
+
+    void place(uint32_t n);
+    void link(uint32_t n, int level, int slot);
+    void unlink(uint32_t n);
+    bool fires_after(uint32_t a, uint32_t b) const;
+    void push_ready(uint32_t n);
+    uint32_t pop_ready();
+
+    // Moves now_tick_ to the next tick with work, or to target if none
+    // comes first; returns false when nothing lies before target
+    bool step(uint64_t target);
+    void redistribute(int level, int slot);
+    int next_occupied(int level, int after) const;
+};
+
+} // namespace quantflow
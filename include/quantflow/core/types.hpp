@@ -15,6 +15,7 @@ namespace quantflow {
 using Symbol = std::string;
 using OrderID = uint64_t;
 using FillID = uint64_t;
+using TimerID = uint64_t;
 using StrategyID = std::string;
 using ExchangeID = std::string;
 
@@ -138,26 +139,27 @@ enum class TimeInForce {
     FOK
 };
 
-// Order structure
+// Order structure. Every field has a default, so `Order order;` is a
+// well-defined flat MARKET order (stop_price 0 = none).
 struct Order {
-    OrderID id;
+    OrderID id = 0;
     Symbol symbol;
-    OrderType type;
-    OrderSide side;
-    double quantity;
-    double price;
-    double stop_price;
-    TimeInForce tif;
-    OrderStatus status;
+    OrderType type = OrderType::MARKET;
+    OrderSide side = OrderSide::BUY;
+    double quantity = 0.0;
+    double price = 0.0;
+    double stop_price = 0.0;
+    TimeInForce tif = TimeInForce::DAY;
+    OrderStatus status = OrderStatus::PENDING;
     
-    double filled_quantity;
-    double remaining_quantity;
-    double avg_fill_price;
+    double filled_quantity = 0.0;
+    double remaining_quantity = 0.0;
+    double avg_fill_price = 0.0;
     
-    Timestamp created_at;
-    Timestamp submitted_at;
-    Timestamp updated_at;
-    Timestamp filled_at;
+    Timestamp created_at = 0;
+    Timestamp submitted_at = 0;
+    Timestamp updated_at = 0;
+    Timestamp filled_at = 0;
     
     StrategyID strategy_id;
     ExchangeID exchange_id;
@@ -229,6 +231,8 @@ struct PortfolioState {
     
     double total_value() const { return equity; }
     
+    // Scans the whole map. PositionBook::num_open (and so
+    // PortfolioManager::num_positions) keeps this count in O(1).
     int num_positions() const {
         return std::count_if(positions.begin(), positions.end(),
             [](const auto& p) { return !p.second.is_flat(); });
@@ -239,6 +243,7 @@ struct PortfolioState {
 enum class EventType {
     TICK,
     BAR,
+    ORDER_BOOK,
     ORDER_UPDATE,
     FILL,
     POSITION_UPDATE,
@@ -246,14 +251,22 @@ enum class EventType {
     SYSTEM
 };
 
-struct Event {
-    EventType type;
+struct TimerEvent {
+    TimerID timer_id;
+    Timestamp timestamp;
+    uint64_t user_data;
+};
+
+enum class SystemEventCode {
+    START,
+    STOP,
+    END_OF_DATA,
+    CHECKPOINT
+};
+
+struct SystemEvent {
+    SystemEventCode code;
     Timestamp timestamp;
-    void* data;
-    
-    bool operator<(const Event& other) const {
-        return timestamp < other.timestamp;
-    }
 };
 
 // Constants
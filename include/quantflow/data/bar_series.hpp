@@ -0,0 +1,59 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace quantflow {
+namespace data {
+
+class BarSeries;
+using BarSeriesPtr = std::shared_ptr<const BarSeries>;
+
+// Immutable, timestamp-ordered bar series. Built once and shared read-only
+// between any number of backtest engines.
+class BarSeries {
+public:
+    using const_iterator = std::vector<Bar>::const_iterator;
+
+    static BarSeriesPtr create(std::vector<Bar> bars) {
+        std::stable_sort(bars.begin(), bars.end(),
+            [](const Bar& a, const Bar& b) { return a.timestamp < b.timestamp; });
+        return BarSeriesPtr(new BarSeries(std::move(bars)));
+    }
+
+    // Caller guarantees bars are already ordered by timestamp
+    static BarSeriesPtr from_sorted(std::vector<Bar> bars) {
+        return BarSeriesPtr(new BarSeries(std::move(bars)));
+    }
+
+    const_iterator begin() const { return bars_.begin(); }
+    const_iterator end() const { return bars_.end(); }
+
+    const Bar& operator[](size_t index) const { return bars_[index]; }
+    const Bar& front() const { return bars_.front(); }
+    const Bar& back() const { return bars_.back(); }
+
+    size_t size() const { return bars_.size(); }
+    bool empty() const { return bars_.empty(); }
+
+    const Bar* data() const { return bars_.data(); }
+
+    // Index of the first bar with timestamp >= ts
+    size_t lower_bound(Timestamp ts) const {
+        auto it = std::lower_bound(bars_.begin(), bars_.end(), ts,
+            [](const Bar& bar, Timestamp t) { return bar.timestamp < t; });
+        return static_cast<size_t>(std::distance(bars_.begin(), it));
+    }
+
+    size_t get_size_bytes() const { return bars_.size() * sizeof(Bar); }
+
+private:
+    explicit BarSeries(std::vector<Bar> bars) : bars_(std::move(bars)) {}
+
+    const std::vector<Bar> bars_;
+};
+
+} // namespace data
+} // namespace quantflow
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/utils/binary_io.hpp"
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+namespace execution {
+
+struct FillSimulatorConfig {
+    double slippage_bps = 5.0;
+
+    // Cap on the share of a bar's volume our orders may take (0 = no cap).
+    // The budget is shared by all orders on the symbol within that bar.
+    double max_participation = 0.0;
+};
+
+struct SimulatedFill {
+    Order* order;
+    double price;
+    double quantity;
+    double slippage;    // cost versus the undisturbed price, >= 0
+};
+
+// Bar-level fill model for MARKET, LIMIT, STOP and STOP_LIMIT orders.
+//
+// Orders submitted while their symbol's bar is being processed are checked
+// against that bar's close only (the strategy decided at the close). So are
+// orders submitted at the same timestamp before their symbol's bar arrives,
+// e.g. from another symbol's bar: that bar's open/high/low predate the
+// decision. Orders left resting are matched on later bars (timestamps after
+// created_at) against open/high/low: market orders fill at the open, limits
+// at their price (or the open on a gap through it), stops trigger on the
+// high/low and fill like market orders.
+// A triggered STOP becomes MARKET and a triggered STOP_LIMIT becomes LIMIT,
+// so the trigger survives in the order itself.
+//
+// Resting orders are held per symbol in price-sorted books, so a bar only
+// visits orders it can actually trigger. Orders are referenced, not
+// copied: they must stay at a stable address until they are no longer
+// open. Cancelled orders are dropped lazily when reached.
+class FillSimulator {
+public:
+    explicit FillSimulator(const FillSimulatorConfig& config);
+
+    // Adds an order. With bar set to the current bar for order.symbol the
+    // order is first tried at that bar's close; otherwise it waits for the
+    // next bar of its symbol.
+    void submit(Order& order, const Bar* bar, std::vector<SimulatedFill>& fills);
+
+    // Matches resting orders for bar.symbol against the bar's range, then
+    // tries orders created at bar.timestamp against its close
+    void match(const Bar& bar, std::vector<SimulatedFill>& fills);
+
+    void clear();
+    size_t num_resting(const Symbol& symbol) const;
+
+    // Open resting orders by id, queue by queue in matching order, so a
+    // restore puts them back with the same priority. load_state() takes
+    // the open orders by id; the simulator must be empty.
+    void save_state(utils::BinaryWriter& out) const;
+    void load_state(utils::BinaryReader& in, std::unordered_map<OrderID, Order*>& orders);
+
+private:
+    template<typename Compare>
+    using PriceBook = std::multimap<double, Order*, Compare>;
+
+    struct SymbolBook {
+        std::vector<Order*> arrived;    // submitted without a bar, not yet matched
+        std::deque<Order*> market;
+        PriceBook<std::greater<double>> buy_limits;
+        PriceBook<std::less<double>> sell_limits;
+        PriceBook<std::less<double>> buy_stops;
+        PriceBook<std::greater<double>> sell_stops;
+
+        Timestamp budget_time = std::numeric_limits<Timestamp>::min();
+        double budget = 0.0;
+    };
+
+    FillSimulatorConfig config_;
+    std::unordered_map<Symbol, SymbolBook> books_;
+
+    void reset_budget(SymbolBook& book, const Bar& bar) const;
+    void rest(SymbolBook& book, Order& order);
+
+    // Tries an order at the bar's close; returns true if the order is done
+    bool fill_at_close(SymbolBook& book, Order& order, const Bar& bar,
+                       std::vector<SimulatedFill>& fills);
+
+    // Fills up to the remaining budget; returns true if the order is done
+    bool fill(SymbolBook& book, Order& order, double price, bool marketable,
+              std::vector<SimulatedFill>& fills) const;
+
+    template<typename Book, typename Triggered>
+    void trigger_stops(SymbolBook& book, Book& stops, Triggered&& triggered,
+                       const Bar& bar, std::vector<SimulatedFill>& fills);
+
+    template<typename Book, typename Crossed>
+    void match_limits(SymbolBook& book, Book& limits, Crossed&& crossed,
+                      const Bar& bar, std::vector<SimulatedFill>& fills);
+};
+
+} // namespace execution
+} // namespace quantflow
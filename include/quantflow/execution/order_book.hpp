@@ -0,0 +1,196 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+namespace execution {
+
+struct OrderBookConfig {
+    double min_price = 0.0;        // price of level 0
+    double tick_size = 0.01;
+    size_t num_levels = 1 << 16;   // price range = num_levels * tick_size
+    size_t initial_orders = 1024;  // pool size at construction
+    size_t max_orders = 1 << 20;   // cap the pool may grow to (resting orders)
+};
+
+// A fill of one of our own orders
+struct BookFill {
+    OrderID order_id;
+    double price;
+    uint64_t quantity;
+    bool passive;       // true if our order was resting in the book
+};
+
+// Price-time priority book for one symbol, driven by an L3 (market-by-order)
+// feed with our own orders queued among the market's.
+//
+// Price levels are indexed by tick offset from min_price, with a bitmap per
+// side to find the next non-empty level. Levels are stored in pages that
+// are allocated when first used, so a book only pays for the price range
+// it trades in. Orders are nodes drawn from a pool (doubling up to
+// max_orders) and linked into an intrusive FIFO per level; an
+// open-addressing table maps OrderID to node. add, cancel, reduce and
+// execute are O(1), and allocation-free once the pool and pages cover the
+// working set.
+//
+// Own orders know how much quantity is queued ahead of them. Quantity
+// leaving a level in front of all our orders there is only added to a
+// per-level counter that each own order reads against its entry mark;
+// changes behind one of our orders walk that level's own orders.
+//
+// When the feed executes a foreign order that sits behind one of ours at
+// the same level, the aggressor would have reached us first, so ours fills
+// before the foreign execution is applied.
+class LimitOrderBook {
+public:
+    explicit LimitOrderBook(const OrderBookConfig& config);
+
+    // Market-by-order feed
+    bool add(OrderID id, bool is_buy, double price, uint64_t quantity);
+    bool cancel(OrderID id);
+    bool reduce(OrderID id, uint64_t quantity);
+    bool execute(OrderID id, uint64_t quantity, std::vector<BookFill>& fills);
+
+    // Own orders: crosses the spread first, the remainder rests (limit) or
+    // is dropped (market, price <= 0)
+    bool add_own(OrderID id, bool is_buy, double price, uint64_t quantity,
+                 std::vector<BookFill>& fills);
+    bool cancel_own(OrderID id) { return cancel(id); }
+
+    bool contains(OrderID id) const;
+    uint64_t queue_ahead(OrderID id) const;
+    uint64_t remaining(OrderID id) const;
+
+    double best_bid() const;
+    double best_ask() const;
+    double mid_price() const;
+    uint64_t depth_at(bool is_buy, double price) const;
+
+    // Top-of-book snapshot into the shared OrderBook type
+    void snapshot(OrderBook& out, size_t max_levels) const;
+
+    size_t num_orders() const { return num_orders_; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFFu;
+
+    struct Node {
+        OrderID id;
+        uint64_t quantity;
+        uint64_t sequence;
+        uint64_t ahead;     // own orders: quantity queued in front, as of
+        uint64_t mark;      // the level's front_removed equal to mark
+        uint32_t level;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t own_prev;  // own orders are also linked per level,
+        uint32_t own_next;  // in queue order
+        bool is_buy;
+        bool own;
+    };
+
+    struct Level {
+        uint64_t quantity = 0;
+        uint64_t front_removed = 0;  // left from in front of every own order
+        uint32_t head = NIL;
+        uint32_t tail = NIL;
+        uint32_t count = 0;
+        uint32_t own_head = NIL;
+        uint32_t own_tail = NIL;
+    };
+
+    static constexpr uint32_t PAGE_BITS = 10;
+    static constexpr uint32_t PAGE_LEVELS = 1u << PAGE_BITS;
+
+    struct Side {
+        std::vector<std::unique_ptr<Level[]>> pages;    // null until used
+        std::vector<uint64_t> bits;
+
+        // Level i of a page already in use
+        Level& at(uint32_t i) { return pages[i >> PAGE_BITS][i & (PAGE_LEVELS - 1)]; }
+        const Level& at(uint32_t i) const { return pages[i >> PAGE_BITS][i & (PAGE_LEVELS - 1)]; }
+        Level& touch(uint32_t i);
+        const Level* find(uint32_t i) const;
+    };
+
+    // OrderID -> node index, linear probing with backward-shift deletion;
+    // doubles to stay at most half full
+    class IdIndex {
+    public:
+        explicit IdIndex(size_t max_entries);
+        bool insert(OrderID id, uint32_t node);
+        uint32_t find(OrderID id) const;
+        void erase(OrderID id);
+
+    private:
+        std::vector<OrderID> keys_;     // 0 marks an empty slot
+        std::vector<uint32_t> values_;
+        size_t mask_;
+        size_t size_;
+
+        size_t slot_of(OrderID id) const;
+        void grow();
+    };
+
+    OrderBookConfig config_;
+    Side bids_;
+    Side asks_;
+    std::vector<Node> nodes_;
+    uint32_t free_head_;
+    IdIndex index_;
+    uint64_t next_sequence_;
+    size_t num_orders_;
+    int64_t best_bid_;      // level index, -1 when empty
+    int64_t best_ask_;      // level index, num_levels when empty
+
+    bool to_level(double price, uint32_t& level) const;
+    double to_price(uint32_t level) const;
+
+    Side& side(bool is_buy) { return is_buy ? bids_ : asks_; }
+    const Side& side(bool is_buy) const { return is_buy ? bids_ : asks_; }
+
+    bool grow_pool();
+    uint64_t ahead_of(const Node& node) const;
+
+    uint32_t insert(OrderID id, bool is_buy, uint32_t level, uint64_t quantity, bool own);
+    void unlink(uint32_t node);
+    void take(uint32_t node, uint64_t quantity);
+    void refresh_best(bool is_buy);
+
+    // Fills own orders queued in front of `node` against `quantity` traded
+    void fill_own_ahead(uint32_t node, uint64_t quantity, std::vector<BookFill>& fills);
+};
+
+// One LimitOrderBook per symbol, created on first use
+class MatchingEngine {
+public:
+    explicit MatchingEngine(const OrderBookConfig& default_config)
+        : default_config_(default_config) {}
+
+    LimitOrderBook& book(const Symbol& symbol) {
+        auto it = books_.find(symbol);
+        if (it == books_.end()) {
+            it = books_.emplace(symbol, std::make_unique<LimitOrderBook>(default_config_)).first;
+        }
+        return *it->second;
+    }
+
+    LimitOrderBook& add_book(const Symbol& symbol, const OrderBookConfig& config) {
+        auto& slot = books_[symbol];
+        slot = std::make_unique<LimitOrderBook>(config);
+        return *slot;
+    }
+
+    size_t num_books() const { return books_.size(); }
+
+private:
+    OrderBookConfig default_config_;
+    std::unordered_map<Symbol, std::unique_ptr<LimitOrderBook>> books_;
+};
+
+} // namespace execution
+} // namespace quantflow
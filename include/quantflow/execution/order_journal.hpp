@@ -0,0 +1,155 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/execution/order_record.hpp"
+#include "quantflow/utils/mapped_file.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace quantflow {
+namespace execution {
+
+struct OrderJournalConfig {
+    std::string path;                       // empty = no journal
+    size_t initial_size = size_t{64} << 20; // the file doubles when full
+    size_t max_size = size_t{1} << 40;      // address space reserved up front
+    Duration commit_interval = 2000000;     // group commit period (ns)
+};
+
+// Append-only journal of order states, fills and interned strings in a
+// memory-mapped file.
+//
+// Appends copy into the mapping and return; they never wait on the disk.
+// A background thread msyncs everything appended since its last pass once
+// per commit interval (or sooner on commit()), so one flush covers a whole
+// group of records. sync() blocks until what was appended before the call
+// is durable, and throws if a writeback has failed.
+//
+// The file is mapped through utils::MappedFile. When it fills, the file
+// doubles; on POSIX only the new tail is mapped, into address space
+// reserved up to max_size, so the mapping never moves and growing it does
+// not wait for the flusher's msync. Where the mapping has to move instead
+// (Windows), growing waits for any flush in progress. Appending past
+// max_size throws.
+//
+// Every entry carries its size and a checksum. Recovery walks the mapping
+// sequentially and stops at the first empty or torn entry; the file is
+// truncated there, and appending resumes from that point.
+class OrderJournal {
+public:
+    enum class EntryType : uint16_t {
+        ORDER = 1,      // OrderRecord, latest state wins
+        FILL = 2,       // FillRecord
+        STRING = 3      // handle, length, bytes
+    };
+
+    explicit OrderJournal(const OrderJournalConfig& config);
+    ~OrderJournal();
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    void append_order(const OrderRecord& record);
+    void append_fill(const FillRecord& fill);
+    void append_string(StringHandle handle, std::string_view str);
+
+    void commit();
+    void sync();
+
+    // Calls visitor.on_order / on_fill / on_string for every entry present
+    // when the journal was opened, in append order
+    template<typename Visitor>
+    size_t replay(Visitor& visitor) const;
+
+    size_t size_bytes() const { return written_.load(std::memory_order_acquire); }
+
+private:
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t reserved[7];
+    };
+
+    struct EntryHeader {
+        uint32_t size;      // header + payload, multiple of 8; 0 = end
+        uint16_t type;
+        uint16_t reserved;
+        uint64_t checksum;
+    };
+
+    static constexpr uint32_t MAGIC = 0x4A524651;  // "QFRJ"
+    static constexpr uint32_t VERSION = 2;   // 2: per-order IDs inline in OrderRecord
+
+    OrderJournalConfig config_;
+    utils::MappedFile file_;
+    char* base_;            // file_.data(), changed only while mutex_ is held
+    size_t capacity_;       // file size, all of it mapped
+    size_t recovered_end_;
+    std::atomic<size_t> written_;
+
+    // Flusher state
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable synced_cv_;
+    std::atomic<bool> commit_requested_;
+    bool stopping_;
+    size_t synced_;
+    int sync_error_;        // error of the first failed flush, 0 if none
+    std::thread flusher_;
+
+    static uint64_t checksum(const char* data, size_t size);
+
+    void grow(size_t capacity);
+    size_t scan() const;
+    char* reserve(size_t size);
+    void append(EntryType type, const void* payload, size_t size);
+    void flush_loop();
+    void flush_locked();
+};
+
+template<typename Visitor>
+size_t OrderJournal::replay(Visitor& visitor) const {
+    size_t count = 0;
+    size_t offset = sizeof(FileHeader);
+
+    while (offset < recovered_end_) {
+        EntryHeader header;
+        std::memcpy(&header, base_ + offset, sizeof(header));
+        const char* payload = base_ + offset + sizeof(header);
+
+        switch (static_cast<EntryType>(header.type)) {
+            case EntryType::ORDER: {
+                OrderRecord record;
+                std::memcpy(&record, payload, sizeof(record));
+                visitor.on_order(record);
+                break;
+            }
+            case EntryType::FILL: {
+                FillRecord fill;
+                std::memcpy(&fill, payload, sizeof(fill));
+                visitor.on_fill(fill);
+                break;
+            }
+            case EntryType::STRING: {
+                uint32_t handle;
+                uint32_t length;
+                std::memcpy(&handle, payload, sizeof(handle));
+                std::memcpy(&length, payload + sizeof(handle), sizeof(length));
+                visitor.on_string(handle, std::string_view(payload + 2 * sizeof(uint32_t), length));
+                break;
+            }
+        }
+
+        offset += header.size;
+        ++count;
+    }
+    return count;
+}
+
+} // namespace execution
+} // namespace quantflow
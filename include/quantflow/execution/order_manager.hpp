@@ -1,46 +1,364 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/execution/order_journal.hpp"
+#include "quantflow/execution/order_record.hpp"
+#include "quantflow/utils/broadcast_ring.hpp"
+#include "quantflow/utils/lockfree_queue.hpp"
+#include "quantflow/utils/string_pool.hpp"
+#include <atomic>
 #include <unordered_map>
 #include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 namespace quantflow {
 namespace execution {
 
-using OrderUpdateCallback = std::function<void(const Order&)>;
-using FillCallback = std::function<void(const Fill&)>;
+using OrderUpdateCallback = std::function<void(const OrderRecord&)>;
+using FillCallback = std::function<void(const FillRecord&)>;
 
+class OrderView;
+
+enum class NotifyBackpressure {
+    BLOCK,      // the owner waits for the slowest subscriber
+    DROP        // the notification is dropped and counted
+};
+
+struct NotificationStats {
+    uint64_t published = 0;
+    uint64_t dropped = 0;
+    double avg_publish_latency = 0.0;   // ns, backpressure waits included
+    uint64_t max_publish_latency = 0;   // ns
+    uint64_t lag = 0;                   // slowest subscriber, events behind now
+    uint64_t max_lag = 0;               // worst any subscriber has been behind
+};
+
+struct OrderManagerConfig {
+    size_t expected_orders = 0;     // slabs allocated up front
+    size_t queue_capacity = 1024;   // per producer, power of two
+    size_t max_producers = 64;
+    size_t id_block = 1024;         // IDs a producer reserves at a time
+    OrderJournalConfig journal;     // set a path to persist and recover
+    
+    // Ring shared by subscribe()d consumers
+    size_t notify_capacity = 4096;  // power of two
+    size_t max_subscribers = 8;
+    NotifyBackpressure notify_backpressure = NotifyBackpressure::BLOCK;
+};
+
+// Orders are kept as OrderRecords in fixed-size slabs addressed directly by
+// OrderID, with symbol, strategy and exchange names interned and per-order
+// IDs stored inline. Once symbols and strategy names have been seen,
+// submit, cancel and fill perform no heap allocation.
+//
+// One owning thread applies every state change. Other threads each get a
+// Producer, which pushes commands into its own SPSC queue; the owner drains
+// the queues in process() (or on its own thread after start()), so
+// producers never share a lock or a cache line. Callbacks run on the owner
+// thread with no lock held.
+//
+// Readers on any thread copy records out through a per-record sequence
+// lock: they never block the owner and always see a state the owner
+// actually published.
+//
+// Open orders are indexed as they open and close: one set overall plus one
+// list per symbol and per strategy, with the open count kept alongside.
+// Orders that reach a terminal state drop out of every index and stay only
+// in their slab slot, so queries cost the number of open orders rather
+// than the session's order count.
+//
+// With a journal configured, every state change and fill is appended to it
+// on the owner thread, and construction replays an existing journal to
+// restore the orders, their indexes and the ID counter.
+//
+// on_order_update / on_fill callbacks run synchronously on the owner
+// thread. Subscribers added with subscribe() instead receive copies through
+// a broadcast ring, each on its own consumer thread, so a slow subscriber
+// only holds up the owner when it falls a whole ring behind (or never, with
+// NotifyBackpressure::DROP).
 class OrderManager {
 public:
-    OrderManager();
+    class Producer;
+    
+    explicit OrderManager(const OrderManagerConfig& config = {});
+    ~OrderManager();
     
-    OrderID submit_order(Order order);
+    OrderManager(const OrderManager&) = delete;
+    OrderManager& operator=(const OrderManager&) = delete;
+    
+    // Owner-thread entry points, applied immediately. Use them only while no
+    // owner thread is running (or from a callback, which runs on it).
+    OrderID submit_order(const Order& order);
     void cancel_order(OrderID order_id);
     void modify_order(OrderID order_id, double new_price, double new_quantity);
     
+    // Batch forms: one timestamp and one contiguous ID range for the whole
+    // batch, and order callbacks run in a single pass once all of it is
+    // applied. IDs are returned in input order.
+    std::vector<OrderID> submit_orders(const std::vector<Order>& orders);
+    void cancel_orders(const std::vector<OrderID>& order_ids);
+    
+    // Replaces the state of an order issued by this manager (others are ignored)
     void update_order(const Order& order);
     void add_fill(const Fill& fill);
     
-    const Order* get_order(OrderID order_id) const;
-    std::vector<Order> get_open_orders() const;
-    std::vector<Order> get_orders_by_symbol(const Symbol& symbol) const;
+    // One per submitting thread; owned by the manager
+    Producer& create_producer();
     
-    void on_order_update(OrderUpdateCallback callback);
-    void on_fill(FillCallback callback);
+    // Applies queued producer commands; returns how many were applied
+    size_t process();
     
+    // Runs process() on a dedicated owner thread until stop(), which
+    // drains what is still queued
+    void start();
+    void stop();
+    
+    // Lock-free, callable from any thread
+    bool get_order(OrderID order_id, OrderRecord& out) const;
     size_t num_open_orders() const;
     size_t num_total_orders() const;
+    
+    // Views of the open-order indexes. Owner thread only (or while no owner
+    // thread runs); a view is invalidated by the next state change.
+    OrderView get_open_orders() const;
+    OrderView get_open_orders(const Symbol& symbol) const;
+    OrderView get_open_orders_by_strategy(const StrategyID& strategy_id) const;
+    
+    // Expands a record back to an Order (allocates for long strings)
+    Order to_order(const OrderRecord& record) const;
+    const std::string& lookup(StringHandle handle) const;
+    
+    // Set before start()
+    void on_order_update(OrderUpdateCallback callback);
+    void on_fill(FillCallback callback);
+    
+    // Asynchronous subscriber; callbacks run in publish order on a thread
+    // of its own. Add subscribers before the first order; either callback
+    // may be empty.
+    void subscribe(OrderUpdateCallback on_update, FillCallback on_fill);
+    NotificationStats notification_stats() const;
+    
+    // Blocks until everything journaled so far is on disk; no-op without
+    // a journal. The journal otherwise commits on its own interval.
+    void sync_journal();
 
 private:
-    std::unordered_map<OrderID, Order> orders_;
-    std::vector<Fill> fills_;
+    friend class OrderView;
+    
+    static constexpr size_t SLAB_BITS = 12;
+    static constexpr size_t SLAB_SIZE = size_t{1} << SLAB_BITS;
+    static constexpr size_t MAX_SLABS = size_t{1} << 16;
+    
+    struct Slot {
+        std::atomic<uint32_t> version{0};   // 0 = never written, odd = writing
+        OrderRecord record;
+        
+        // Owner-only: positions in the open-order indexes
+        uint32_t open_pos;
+        uint32_t symbol_pos;
+        uint32_t strategy_pos;
+    };
+    
+    struct Command {
+        enum class Kind : uint8_t { SUBMIT, CANCEL, MODIFY, UPDATE, FILL };
+        
+        Kind kind;
+        OrderRecord order;      // CANCEL/MODIFY use id, price, quantity, updated_at
+        FillRecord fill;
+    };
+    
+    // Thread-local front end to the shared string pool: hits are lock-free,
+    // a string new to this cache is interned once under the pool lock
+    class InternCache {
+    public:
+        explicit InternCache(OrderManager& manager) : manager_(manager) {}
+        StringHandle intern(const std::string& str);
+        bool find(const std::string& str, StringHandle& handle) const;
+    
+    private:
+        OrderManager& manager_;
+        std::unordered_map<std::string, StringHandle> handles_;
+    };
+    
+    // ID blocks reserved from the shared counter, so allocation is local
+    class IdBlock {
+    public:
+        explicit IdBlock(OrderManager& manager) : manager_(manager), next_(0), end_(0) {}
+        OrderID next();
+    
+    private:
+        OrderManager& manager_;
+        OrderID next_;
+        OrderID end_;
+    };
+    
+    OrderManagerConfig config_;
+    
+    // Slabs are owned by the owner thread; readers go through the table
+    std::vector<std::unique_ptr<Slot[]>> slabs_;
+    std::unique_ptr<std::atomic<Slot*>[]> slab_table_;
+    std::atomic<OrderID> id_cursor_;        // IDs below this may be in use
+    std::atomic<size_t> num_orders_;
+    std::atomic<size_t> open_count_;
+    
+    // Open-order indexes, lists of IDs keyed by interned handle
+    std::vector<OrderID> open_ids_;
+    std::vector<std::vector<OrderID>> by_symbol_;
+    std::vector<std::vector<OrderID>> by_strategy_;
+    const std::vector<OrderID> no_orders_;
+    
+    utils::StringPool strings_;
+    mutable std::mutex strings_mutex_;
+    
+    std::atomic<uint32_t> num_strings_;     // pool size, published under the lock
+    
+    // Owner-only; strings reach the journal before any record using them
+    std::unique_ptr<OrderJournal> journal_;
+    uint32_t journaled_strings_;
+    bool recovering_;
     
     OrderUpdateCallback order_callback_;
     FillCallback fill_callback_;
     
-    mutable std::mutex mutex_;
-    OrderID next_order_id_;
+    // While a batch is applied, changed IDs collect here instead of
+    // notifying one by one
+    std::vector<OrderID>* deferred_;
+    
+    struct Notification {
+        enum class Kind : uint8_t { ORDER, FILL };
+        
+        Kind kind;
+        OrderRecord order;
+        FillRecord fill;
+    };
+    
+    struct Subscriber {
+        OrderUpdateCallback on_update;
+        FillCallback on_fill;
+        size_t consumer;
+        std::atomic<uint64_t> max_lag{0};
+        std::thread thread;
+    };
+    
+    std::unique_ptr<utils::BroadcastRing<Notification>> notifications_;
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+    std::atomic<bool> notifying_;
+    
+    // Written by the owner only
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> publish_ns_total_;
+    std::atomic<uint64_t> publish_ns_max_;
+    
+    std::vector<std::unique_ptr<Producer>> producers_;
+    std::atomic<size_t> num_producers_;
+    std::mutex producers_mutex_;
+    
+    InternCache owner_strings_;
+    IdBlock owner_ids_;
+    
+    std::thread owner_;
+    std::atomic<bool> running_;
+    
+    Slot* find(OrderID order_id) const;
+    Slot* find_live(OrderID order_id) const;
+    Slot& allocate(OrderID order_id);
+    const OrderRecord& record(OrderID order_id) const { return find(order_id)->record; }
+    
+    template<typename Fn>
+    static void write(Slot& slot, Fn&& fn);
+    
+    // Writes, keeps the indexes in step and notifies
+    template<typename Fn>
+    void change(Slot& slot, Fn&& fn);
+    
+    void index(Slot& slot);
+    void unindex(Slot& slot, StringHandle symbol, StringHandle strategy);
+    static std::vector<OrderID>& index_list(std::vector<std::vector<OrderID>>& lists,
+                                            StringHandle handle);
+    void erase_at(std::vector<OrderID>& ids, uint32_t pos, uint32_t Slot::*field);
+    
+    void fill_record(OrderRecord& record, const Order& order, InternCache& strings) const;
+    void fill_record(FillRecord& record, const Fill& fill, InternCache& strings) const;
+    void apply(const Command& command);
+    void notify(const std::vector<OrderID>& order_ids);
+    void publish(const Notification& notification);
+    void consume(Subscriber& subscriber);
+    void stop_subscribers();
+    
+    void recover();
+    void journal_strings();
+};
+
+// Submission handle for one thread. Calls enqueue and return at once;
+// when the queue is full they spin until the owner catches up.
+class OrderManager::Producer {
+public:
+    OrderID submit_order(const Order& order);
+    void cancel_order(OrderID order_id);
+    void modify_order(OrderID order_id, double new_price, double new_quantity);
+    void update_order(const Order& order);
+    void add_fill(const Fill& fill);
+    
+    // Enqueued together, publishing to the owner once per queue-full
+    std::vector<OrderID> submit_orders(const std::vector<Order>& orders);
+    void cancel_orders(const std::vector<OrderID>& order_ids);
+
+private:
+    friend class OrderManager;
+    
+    explicit Producer(OrderManager& manager);
+    void push(const Command& command);
+    void push(const Command* commands, size_t count);
+    
+    OrderManager& manager_;
+    utils::SPSCQueue<Command> queue_;
+    std::vector<Command> batch_;
+    InternCache strings_;
+    IdBlock ids_;
+};
+
+// Records of an ID list, read in place
+class OrderView {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = OrderRecord;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const OrderRecord*;
+        using reference = const OrderRecord&;
+        
+        iterator(const OrderManager& manager, const OrderID* pos) : manager_(&manager), pos_(pos) {}
+        
+        reference operator*() const { return manager_->record(*pos_); }
+        pointer operator->() const { return &manager_->record(*pos_); }
+        iterator& operator++() { ++pos_; return *this; }
+        iterator operator++(int) { iterator it = *this; ++pos_; return it; }
+        bool operator==(const iterator& other) const { return pos_ == other.pos_; }
+        bool operator!=(const iterator& other) const { return pos_ != other.pos_; }
+    
+    private:
+        const OrderManager* manager_;
+        const OrderID* pos_;
+    };
+    
+    OrderView(const OrderManager& manager, const std::vector<OrderID>& ids)
+        : manager_(manager), ids_(ids) {}
+    
+    iterator begin() const { return iterator(manager_, ids_.data()); }
+    iterator end() const { return iterator(manager_, ids_.data() + ids_.size()); }
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    const OrderRecord& operator[](size_t i) const { return manager_.record(ids_[i]); }
+    const std::vector<OrderID>& ids() const { return ids_; }
+
+private:
+    const OrderManager& manager_;
+    const std::vector<OrderID>& ids_;
 };
 
 } // namespace execution
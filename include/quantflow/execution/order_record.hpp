@@ -0,0 +1,90 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/utils/string_pool.hpp"
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace quantflow {
+namespace execution {
+
+using StringHandle = utils::StringPool::Handle;
+
+// Text stored in place, NUL-padded; longer values are truncated to N - 1
+template<size_t N>
+struct InlineString {
+    char data[N];
+
+    void assign(std::string_view str) {
+        size_t length = std::min(str.size(), N - 1);
+        std::memcpy(data, str.data(), length);
+        std::memset(data + length, 0, N - length);
+    }
+
+    std::string_view view() const {
+        const void* end = std::memchr(data, 0, N);
+        return std::string_view(data, end ? static_cast<const char*>(end) - data : N);
+    }
+};
+
+// Fixed-size, trivially copyable form of Order. Symbol, strategy and
+// exchange are handles into the owning OrderManager's StringPool; the
+// per-order IDs and the rejection reason are mostly unique, so they are
+// kept inline rather than interned and the pool stays bounded by the
+// number of distinct symbols and strategies.
+struct OrderRecord {
+    OrderID id;
+    double quantity;
+    double price;
+    double stop_price;
+    double filled_quantity;
+    double remaining_quantity;
+    double avg_fill_price;
+
+    Timestamp created_at;
+    Timestamp submitted_at;
+    Timestamp updated_at;
+    Timestamp filled_at;
+
+    StringHandle symbol;
+    StringHandle strategy_id;
+    StringHandle exchange_id;
+    InlineString<32> client_order_id;
+    InlineString<32> exchange_order_id;
+    InlineString<64> rejection_reason;
+
+    OrderType type;
+    OrderSide side;
+    TimeInForce tif;
+    OrderStatus status;
+
+    bool is_buy() const { return side == OrderSide::BUY || side == OrderSide::COVER; }
+    bool is_sell() const { return side == OrderSide::SELL || side == OrderSide::SHORT; }
+    bool is_filled() const { return status == OrderStatus::FILLED; }
+    bool is_open() const {
+        return status == OrderStatus::SUBMITTED ||
+               status == OrderStatus::ACCEPTED ||
+               status == OrderStatus::PARTIALLY_FILLED;
+    }
+};
+
+struct FillRecord {
+    FillID id;
+    OrderID order_id;
+    double quantity;
+    double price;
+    double commission;
+    double slippage;
+    Timestamp timestamp;
+    StringHandle symbol;
+    StringHandle exchange_id;
+    OrderSide side;
+};
+
+static_assert(std::is_trivially_copyable_v<OrderRecord>, "OrderRecord must stay POD");
+static_assert(std::is_trivially_copyable_v<FillRecord>, "FillRecord must stay POD");
+
+} // namespace execution
+} // namespace quantflow
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace quantflow {
+namespace indicators {
+namespace kernels {
+
+// Element-wise stages of the indicators' compute() paths. The recursive
+// parts (running sums, EMA / Wilder smoothing) are inherently serial and
+// stay in the indicators; everything that depends only on inputs and those
+// serial states is done here, four values per AVX2 instruction. Each lane
+// evaluates the streaming expression in the same order, fusing exactly
+// where the streaming code does, so results match update().
+//
+// Callers follow two patterns around these. The serial state is copied
+// into a local for the loop and stored back after it: `out` is a plain
+// double*, so the compiler must assume each store through it could alias a
+// double member and reload that member. Kernels that need scratch run a
+// block at a time into a fixed stack buffer that stays in L1.
+
+// a * b + c, fused when the target has FMA. Paths that must agree bit for
+// bit call this rather than rely on the compiler contracting each alike.
+inline double multiply_add(double a, double b, double c) {
+#ifdef __FMA__
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+}
+
+// data[i] /= divisor (a true division, as value() does)
+inline void divide(double* data, size_t n, double divisor) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d vdivisor = _mm256_set1_pd(divisor);
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(data + i, _mm256_div_pd(_mm256_loadu_pd(data + i), vdivisor));
+    }
+#endif
+    for (; i < n; ++i) {
+        data[i] /= divisor;
+    }
+}
+
+// out[i] = a[i] - b[i]
+inline void subtract(const double* a, const double* b, size_t n, double* out) {
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 4 <= n; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = a[i] - b[i];
+    }
+}
+
+// Gain and loss of each close against the one before; prev precedes in[0]
+inline void gains_losses(const double* in, size_t n, double prev, double* gain, double* loss) {
+    if (n == 0) return;
+    double change = in[0] - prev;
+    gain[0] = (change > 0) ? change : 0.0;
+    loss[0] = (change < 0) ? -change : 0.0;
+    
+    size_t i = 1;
+#ifdef __AVX2__
+    const __m256d vzero = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d vchange = _mm256_sub_pd(_mm256_loadu_pd(in + i), _mm256_loadu_pd(in + i - 1));
+        _mm256_storeu_pd(gain + i, _mm256_and_pd(vchange, _mm256_cmp_pd(vchange, vzero, _CMP_GT_OQ)));
+        _mm256_storeu_pd(loss + i, _mm256_and_pd(_mm256_sub_pd(vzero, vchange),
+                                                 _mm256_cmp_pd(vchange, vzero, _CMP_LT_OQ)));
+    }
+#endif
+    for (; i < n; ++i) {
+        change = in[i] - in[i - 1];
+        gain[i] = (change > 0) ? change : 0.0;
+        loss[i] = (change < 0) ? -change : 0.0;
+    }
+}
+
+// RSI from smoothed gains and losses; the result replaces the gains
+inline void rsi(double* gain, const double* loss, size_t n) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d vzero = _mm256_setzero_pd();
+    const __m256d vone = _mm256_set1_pd(1.0);
+    const __m256d vhundred = _mm256_set1_pd(100.0);
+    const __m256d vneutral = _mm256_set1_pd(50.0);
+    for (; i + 4 <= n; i += 4) {
+        __m256d vloss = _mm256_loadu_pd(loss + i);
+        __m256d rs = _mm256_div_pd(_mm256_loadu_pd(gain + i), vloss);
+        __m256d value = _mm256_sub_pd(vhundred, _mm256_div_pd(vhundred, _mm256_add_pd(vone, rs)));
+        __m256d flat = _mm256_cmp_pd(vloss, vzero, _CMP_EQ_OQ);
+        _mm256_storeu_pd(gain + i, _mm256_blendv_pd(value, vneutral, flat));
+    }
+#endif
+    for (; i < n; ++i) {
+        if (loss[i] == 0.0) {
+            gain[i] = 50.0;
+        } else {
+            double rs = gain[i] / loss[i];
+            gain[i] = 100.0 - (100.0 / (1.0 + rs));
+        }
+    }
+}
+
+// True range of each bar against the previous close; prev_close precedes close[0]
+inline void true_range(const double* high, const double* low, const double* close, size_t n,
+                       double prev_close, double* out) {
+    if (n == 0) return;
+    out[0] = std::max({high[0] - low[0], std::abs(high[0] - prev_close), std::abs(low[0] - prev_close)});
+    
+    size_t i = 1;
+#ifdef __AVX2__
+    const __m256d vsign = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= n; i += 4) {
+        __m256d vhigh = _mm256_loadu_pd(high + i);
+        __m256d vlow = _mm256_loadu_pd(low + i);
+        __m256d vprev = _mm256_loadu_pd(close + i - 1);
+        __m256d hl = _mm256_sub_pd(vhigh, vlow);
+        __m256d hc = _mm256_andnot_pd(vsign, _mm256_sub_pd(vhigh, vprev));
+        __m256d lc = _mm256_andnot_pd(vsign, _mm256_sub_pd(vlow, vprev));
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_max_pd(hl, hc), lc));
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = std::max({high[i] - low[i], std::abs(high[i] - close[i - 1]),
+                           std::abs(low[i] - close[i - 1])});
+    }
+}
+
+// Bands around full windows: output i covers in[i, i + period) with mean[i]
+// as the middle band, and the population standard deviation of the window.
+// Four consecutive windows go in the four lanes, each summed in window order.
+inline void bollinger(const double* in, const double* mean, size_t n, size_t period,
+                      double num_std, double* upper, double* lower) {
+    const double count = static_cast<double>(period);
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d vcount = _mm256_set1_pd(count);
+    const __m256d vnum_std = _mm256_set1_pd(num_std);
+    for (; i + 4 <= n; i += 4) {
+        __m256d vmean = _mm256_loadu_pd(mean + i);
+        __m256d sum_sq = _mm256_setzero_pd();
+        for (size_t k = 0; k < period; ++k) {
+            __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(in + i + k), vmean);
+#ifdef __FMA__
+            sum_sq = _mm256_fmadd_pd(diff, diff, sum_sq);
+#else
+            sum_sq = _mm256_add_pd(sum_sq, _mm256_mul_pd(diff, diff));
+#endif
+        }
+        __m256d std_dev = _mm256_sqrt_pd(_mm256_div_pd(sum_sq, vcount));
+#ifdef __FMA__
+        _mm256_storeu_pd(upper + i, _mm256_fmadd_pd(vnum_std, std_dev, vmean));
+        _mm256_storeu_pd(lower + i, _mm256_fnmadd_pd(vnum_std, std_dev, vmean));
+#else
+        _mm256_storeu_pd(upper + i, _mm256_add_pd(vmean, _mm256_mul_pd(vnum_std, std_dev)));
+        _mm256_storeu_pd(lower + i, _mm256_sub_pd(vmean, _mm256_mul_pd(vnum_std, std_dev)));
+#endif
+    }
+#endif
+    for (; i < n; ++i) {
+        double sum_sq = 0.0;
+        for (size_t k = 0; k < period; ++k) {
+            double diff = in[i + k] - mean[i];
+            sum_sq = multiply_add(diff, diff, sum_sq);
+        }
+        double std_dev = std::sqrt(sum_sq / count);
+        upper[i] = multiply_add(num_std, std_dev, mean[i]);
+        lower[i] = multiply_add(-num_std, std_dev, mean[i]);
+    }
+}
+
+} // namespace kernels
+} // namespace indicators
+} // namespace quantflow
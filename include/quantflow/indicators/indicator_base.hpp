@@ -1,6 +1,9 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/utils/binary_io.hpp"
+#include "quantflow/utils/span.hpp"
+#include <stdexcept>
 #include <vector>
 #include <deque>
 
@@ -14,6 +17,28 @@ public:
     virtual double value() const = 0;
     virtual bool is_ready() const = 0;
     virtual void reset() = 0;
+    
+    // Whole-series form of update(): out[i] is value() after update(in[i]),
+    // and the indicator is left as if each value had been streamed in.
+    // Indicators override this with batch kernels; one call per series.
+    virtual void compute(utils::Span<const double> in, utils::Span<double> out) {
+        check_spans(in, out);
+        for (size_t i = 0; i < in.size(); ++i) {
+            update(in[i]);
+            out[i] = value();
+        }
+    }
+    
+    // Opt-in checkpoint hooks; indicators without them restart cold
+    virtual void save_state(utils::BinaryWriter&) const {}
+    virtual void load_state(utils::BinaryReader&) {}
+
+protected:
+    static void check_spans(utils::Span<const double> in, utils::Span<double> out) {
+        if (out.size() < in.size()) {
+            throw std::invalid_argument("Indicator output span is shorter than its input");
+        }
+    }
 };
 
 } // namespace indicators
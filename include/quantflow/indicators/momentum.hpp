@@ -2,6 +2,7 @@
 
 #include "indicator_base.hpp"
 #include "moving_average.hpp"
+#include "batch_kernels.hpp"
 #include <deque>
 #include <algorithm>
 
@@ -56,6 +57,55 @@ public:
         prev_close_ = 0.0;
         count_ = 0;
     }
+    
+    void compute(utils::Span<const double> in, utils::Span<double> out) override {
+        check_spans(in, out);
+        size_t t = 0;
+        for (; t < in.size() && count_ <= period_; ++t) {
+            RSI::update(in[t]);
+            out[t] = RSI::value();
+        }
+        const size_t n = in.size() - t;
+        if (n == 0) return;
+        
+        // Gains land in `out`, are smoothed in place, then become the RSI
+        constexpr size_t BLOCK = 256;
+        double loss[BLOCK];
+        double avg_gain = avg_gain_;
+        double avg_loss = avg_loss_;
+        for (size_t begin = t; begin < in.size(); begin += BLOCK) {
+            const size_t count = std::min(BLOCK, in.size() - begin);
+            const double prev = (begin == t) ? prev_close_ : in[begin - 1];
+            double* gain = &out[begin];
+            kernels::gains_losses(&in[begin], count, prev, gain, loss);
+            for (size_t k = 0; k < count; ++k) {
+                avg_gain = (avg_gain * (period_ - 1) + gain[k]) / period_;
+                avg_loss = (avg_loss * (period_ - 1) + loss[k]) / period_;
+                gain[k] = avg_gain;
+                loss[k] = avg_loss;
+            }
+            kernels::rsi(gain, loss, count);
+        }
+        avg_gain_ = avg_gain;
+        avg_loss_ = avg_loss;
+        
+        prev_close_ = in[in.size() - 1];
+        count_ += static_cast<int>(n);
+    }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        out.write(avg_gain_);
+        out.write(avg_loss_);
+        out.write(prev_close_);
+        out.write(count_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        in.read(avg_gain_);
+        in.read(avg_loss_);
+        in.read(prev_close_);
+        in.read(count_);
+    }
 
 private:
     int period_;
@@ -111,6 +161,42 @@ public:
         signal_ema_.reset();
         initialized_ = false;
     }
+    
+    void compute(utils::Span<const double> in, utils::Span<double> out) override {
+        check_spans(in, out);
+        for (size_t t = 0; t < in.size(); ++t) {
+            MACD::update(in[t]);
+            out[t] = macd_line();
+        }
+    }
+    
+    // All three lines; the histogram is taken in one vector pass
+    void compute(utils::Span<const double> in, utils::Span<double> macd,
+                 utils::Span<double> signal, utils::Span<double> histogram) {
+        check_spans(in, macd);
+        check_spans(in, signal);
+        check_spans(in, histogram);
+        for (size_t t = 0; t < in.size(); ++t) {
+            MACD::update(in[t]);
+            macd[t] = macd_line();
+            signal[t] = signal_line();
+        }
+        kernels::subtract(macd.data(), signal.data(), in.size(), histogram.data());
+    }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        fast_ema_.save_state(out);
+        slow_ema_.save_state(out);
+        signal_ema_.save_state(out);
+        out.write(initialized_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        fast_ema_.load_state(in);
+        slow_ema_.load_state(in);
+        signal_ema_.load_state(in);
+        in.read(initialized_);
+    }
 
 private:
     EMA fast_ema_;
@@ -1,46 +1,95 @@
 #pragma once
 
 #include "indicator_base.hpp"
-#include <deque>
-#include <numeric>
+#include "batch_kernels.hpp"
+#include "quantflow/utils/ring_window.hpp"
+#include <algorithm>
 
 namespace quantflow {
 namespace indicators {
 
-class SMA : public Indicator {
+// Simple moving average over a ring window. With Period > 0 the period is
+// fixed at compile time, so the window is inline and the wrap mask and the
+// divisor are constants; SMA takes the period at run time.
+template<size_t Period = 0>
+class BasicSMA : public Indicator {
 public:
-    explicit SMA(int period) : period_(period), sum_(0.0) {}
+    explicit BasicSMA(int period = static_cast<int>(Period))
+        : period_(period), window_(checked_period(period)), sum_(0.0) {}
     
     void update(double value) override {
-        values_.push_back(value);
         sum_ += value;
-        
-        if (values_.size() > static_cast<size_t>(period_)) {
-            sum_ -= values_.front();
-            values_.pop_front();
+        if (window_.full()) {
+            sum_ -= window_.oldest();
         }
+        window_.push(value);
     }
     
     double value() const override {
         if (!is_ready()) return 0.0;
-        return sum_ / period_;
+        return sum_ / period();
     }
     
     bool is_ready() const override {
-        return values_.size() >= static_cast<size_t>(period_);
+        return window_.full();
     }
     
     void reset() override {
-        values_.clear();
+        window_.clear();
         sum_ = 0.0;
     }
+    
+    void compute(utils::Span<const double> in, utils::Span<double> out) override {
+        check_spans(in, out);
+        const size_t period = static_cast<size_t>(this->period());
+        const size_t head = std::min(in.size(), period);
+        for (size_t t = 0; t < head; ++t) {
+            BasicSMA::update(in[t]);
+            out[t] = BasicSMA::value();
+        }
+        if (head == in.size()) return;
+        
+        // The window now lies inside `in`: the running sum is serial, the
+        // division is not
+        double sum = sum_;
+        for (size_t t = head; t < in.size(); ++t) {
+            sum += in[t];
+            sum -= in[t - period];
+            out[t] = sum;
+        }
+        sum_ = sum;
+        kernels::divide(&out[head], in.size() - head, this->period());
+        window_.assign(in.begin(), in.end());
+    }
+    
+    int period() const { return Period > 0 ? static_cast<int>(Period) : period_; }
+    const utils::RingWindow<double, Period>& window() const { return window_; }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        window_.save_state(out);
+        out.write(sum_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        window_.load_state(in);
+        in.read(sum_);
+    }
 
 private:
     int period_;
-    std::deque<double> values_;
+    utils::RingWindow<double, Period> window_;
     double sum_;
+    
+    static size_t checked_period(int period) {
+        if (period <= 0) {
+            throw std::invalid_argument("SMA period must be positive");
+        }
+        return static_cast<size_t>(period);
+    }
 };
 
+using SMA = BasicSMA<>;
+
 class EMA : public Indicator {
 public:
     explicit EMA(int period)
@@ -70,6 +119,33 @@ public:
         ema_ = 0.0;
         initialized_ = false;
     }
+    
+    // The recurrence is serial; this drops the per-value virtual call and
+    // the first-value branch
+    void compute(utils::Span<const double> in, utils::Span<double> out) override {
+        check_spans(in, out);
+        size_t t = 0;
+        if (!initialized_ && !in.empty()) {
+            EMA::update(in[t]);
+            out[t++] = ema_;
+        }
+        double ema = ema_;
+        for (; t < in.size(); ++t) {
+            ema = (in[t] - ema) * multiplier_ + ema;
+            out[t] = ema;
+        }
+        ema_ = ema;
+    }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        out.write(ema_);
+        out.write(initialized_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        in.read(ema_);
+        in.read(initialized_);
+    }
 
 private:
     int period_;
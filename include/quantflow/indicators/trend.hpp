@@ -31,6 +31,16 @@ public:
         adx_ = 0.0;
         initialized_ = false;
     }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        out.write(adx_);
+        out.write(initialized_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        in.read(adx_);
+        in.read(initialized_);
+    }
 
 private:
     int period_;
@@ -2,25 +2,24 @@
 
 #include "indicator_base.hpp"
 #include "moving_average.hpp"
+#include "batch_kernels.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace quantflow {
 namespace indicators {
 
-class BollingerBands : public Indicator {
+// Bands around a simple moving average; the deviation is taken over the
+// average's own window rather than a second copy of it
+template<size_t Period = 0>
+class BasicBollingerBands : public Indicator {
 public:
-    BollingerBands(int period = 20, double num_std = 2.0)
-        : period_(period),
-          num_std_(num_std),
+    BasicBollingerBands(int period = Period > 0 ? static_cast<int>(Period) : 20, double num_std = 2.0)
+        : num_std_(num_std),
           sma_(period) {}
     
     void update(double value) override {
-        values_.push_back(value);
         sma_.update(value);
-        
-        if (values_.size() > static_cast<size_t>(period_)) {
-            values_.pop_front();
-        }
     }
     
     double value() const override {
@@ -28,11 +27,11 @@ public:
     }
     
     double upper_band() const {
-        return sma_.value() + num_std_ * std_dev();
+        return kernels::multiply_add(num_std_, std_dev(), sma_.value());
     }
     
     double lower_band() const {
-        return sma_.value() - num_std_ * std_dev();
+        return kernels::multiply_add(-num_std_, std_dev(), sma_.value());
     }
     
     bool is_ready() const override {
@@ -40,31 +39,67 @@ public:
     }
     
     void reset() override {
-        values_.clear();
         sma_.reset();
     }
+    
+    void compute(utils::Span<const double> in, utils::Span<double> out) override {
+        sma_.compute(in, out);
+    }
+    
+    // Middle, upper and lower bands. Past the first period every window is
+    // inside `in`, so the bands of four consecutive bars are computed at once.
+    void compute(utils::Span<const double> in, utils::Span<double> middle,
+                 utils::Span<double> upper, utils::Span<double> lower) {
+        check_spans(in, middle);
+        check_spans(in, upper);
+        check_spans(in, lower);
+        const size_t period = static_cast<size_t>(sma_.period());
+        const size_t head = std::min(in.size(), period);
+        for (size_t t = 0; t < head; ++t) {
+            sma_.update(in[t]);
+            middle[t] = value();
+            upper[t] = upper_band();
+            lower[t] = lower_band();
+        }
+        if (head == in.size()) return;
+        
+        const size_t rest = in.size() - head;
+        sma_.compute(in.subspan(head, rest), middle.subspan(head, rest));
+        kernels::bollinger(&in[head - period + 1], &middle[head], rest, period, num_std_,
+                           &upper[head], &lower[head]);
+    }
+    
+    // The window is the average's, so its state is all there is
+    void save_state(utils::BinaryWriter& out) const override {
+        sma_.save_state(out);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        sma_.load_state(in);
+    }
 
 private:
-    int period_;
     double num_std_;
-    SMA sma_;
-    std::deque<double> values_;
+    BasicSMA<Period> sma_;
     
     double std_dev() const {
-        if (values_.size() < 2) return 0.0;
+        const auto& window = sma_.window();
+        if (window.size() < 2) return 0.0;
         
         double mean = sma_.value();
         double sum_sq = 0.0;
         
-        for (double val : values_) {
+        window.for_each([&](double val) {
             double diff = val - mean;
-            sum_sq += diff * diff;
-        }
+            sum_sq = kernels::multiply_add(diff, diff, sum_sq);
+        });
         
-        return std::sqrt(sum_sq / values_.size());
+        return std::sqrt(sum_sq / window.size());
     }
 };
 
+using BollingerBands = BasicBollingerBands<>;
+
 class ATR : public Indicator {
 public:
     explicit ATR(int period = 14)
@@ -101,6 +136,71 @@ public:
         prev_close_ = 0.0;
         initialized_ = false;
     }
+    
+    // A close series alone has no true range, and update(double) ignores
+    // its input, so the single-series form would only repeat atr_
+    void compute(utils::Span<const double>, utils::Span<double>) override {
+        throw std::invalid_argument("ATR needs high, low and close: use the column or Bar form of compute()");
+    }
+    
+    // Batch form of update_bar() over column arrays: true ranges in vector
+    // passes, then the serial smoothing
+    void compute(utils::Span<const double> high, utils::Span<const double> low,
+                 utils::Span<const double> close, utils::Span<double> out) {
+        const size_t n = close.size();
+        if (high.size() < n || low.size() < n) {
+            throw std::invalid_argument("ATR needs a high and low for every close");
+        }
+        check_spans(close, out);
+        if (n == 0) return;
+        
+        size_t t = 0;
+        if (!initialized_) {
+            atr_ = high[0] - low[0];
+            prev_close_ = close[0];
+            initialized_ = true;
+            out[0] = atr_;
+            t = 1;
+        }
+        
+        // True ranges a block at a time, then Wilder smoothing over them
+        constexpr size_t BLOCK = 256;
+        double range[BLOCK];
+        double atr = atr_;
+        for (size_t begin = t; begin < n; begin += BLOCK) {
+            const size_t count = std::min(BLOCK, n - begin);
+            const double prev = (begin == t) ? prev_close_ : close[begin - 1];
+            kernels::true_range(&high[begin], &low[begin], &close[begin], count, prev, range);
+            for (size_t k = 0; k < count; ++k) {
+                atr = ((period_ - 1) * atr + range[k]) / period_;
+                out[begin + k] = atr;
+            }
+        }
+        atr_ = atr;
+        prev_close_ = close[n - 1];
+    }
+    
+    void compute(utils::Span<const Bar> bars, utils::Span<double> out) {
+        if (out.size() < bars.size()) {
+            throw std::invalid_argument("Indicator output span is shorter than its input");
+        }
+        for (size_t t = 0; t < bars.size(); ++t) {
+            update_bar(bars[t]);
+            out[t] = atr_;
+        }
+    }
+    
+    void save_state(utils::BinaryWriter& out) const override {
+        out.write(atr_);
+        out.write(prev_close_);
+        out.write(initialized_);
+    }
+    
+    void load_state(utils::BinaryReader& in) override {
+        in.read(atr_);
+        in.read(prev_close_);
+        in.read(initialized_);
+    }
 
 private:
     int period_;
@@ -6,6 +6,7 @@
 #include <variant>
 #include <thread>
 #include <atomic>
+#include <chrono>
 
 namespace quantflow {
 namespace market_data {
@@ -33,6 +34,12 @@ public:
     size_t num_subscriptions() const override;
     std::vector<Symbol> subscribed_symbols() const override;
     
+    // Replays on the calling thread, handing each event to sink.publish()
+    // with its concrete type (e.g. an EventBus). Registered callbacks are
+    // not used on this path.
+    template<typename Sink>
+    void replay(Sink& sink);
+    
     void seek(Timestamp timestamp);
     void set_speed(double multiplier);
     Timestamp current_time() const { return current_time_; }
@@ -63,16 +70,81 @@ private:
     Timestamp end_time_;
     
     using TimedEvent = std::pair<Timestamp, std::variant<Tick, Bar, OrderBook>>;
+    
+    struct LaterEvent {
+        bool operator()(const TimedEvent& a, const TimedEvent& b) const {
+            return a.first > b.first;
+        }
+    };
+    
     std::priority_queue<
         TimedEvent,
         std::vector<TimedEvent>,
-        std::greater<TimedEvent>
+        LaterEvent
     > event_queue_;
     
+    // Adapts the std::function callbacks to the typed replay loop
+    struct CallbackSink {
+        HistoricalFeed& feed;
+        
+        void publish(const Tick& tick) { if (feed.tick_callback_) feed.tick_callback_(tick); }
+        void publish(const Bar& bar) { if (feed.bar_callback_) feed.bar_callback_(bar); }
+        void publish(const OrderBook& book) { if (feed.orderbook_callback_) feed.orderbook_callback_(book); }
+    };
+    
     void load_data_file(const Symbol& symbol);
+    void prime_events();
     void replay_events();
+    void pace(Timestamp sim_start_time,
+              std::chrono::steady_clock::time_point replay_start) const;
+    
+    template<typename Sink>
+    void replay_loop(Sink& sink);
     bool read_next_event(const Symbol& symbol);
 };
 
+template<typename Sink>
+void HistoricalFeed::replay(Sink& sink) {
+    if (running_.exchange(true)) {
+        return;
+    }
+    
+    prime_events();
+    replay_loop(sink);
+    running_.store(false);
+}
+
+template<typename Sink>
+void HistoricalFeed::replay_loop(Sink& sink) {
+    do {
+        auto replay_start = std::chrono::steady_clock::now();
+        Timestamp sim_start_time = current_time_;
+        
+        while (running_.load() && !event_queue_.empty()) {
+            auto [timestamp, event_variant] = event_queue_.top();
+            event_queue_.pop();
+            
+            current_time_ = timestamp;
+            
+            if (config_.replay_speed > 0.0) {
+                pace(sim_start_time, replay_start);
+            }
+            
+            std::visit([&sink](const auto& event) { sink.publish(event); }, event_variant);
+            
+            if (std::holds_alternative<Bar>(event_variant)) {
+                const Bar& bar = std::get<Bar>(event_variant);
+                read_next_event(bar.symbol);
+            }
+        }
+        
+        if (config_.loop && running_.load()) {
+            seek(start_time_);
+        } else {
+            break;
+        }
+    } while (true);
+}
+
 } // namespace market_data
 } // namespace quantflow
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include "quantflow/utils/binary_io.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace quantflow {
+namespace portfolio {
+
+// Which open lot a closing fill is matched against first
+enum class LotMethod : uint8_t {
+    FIFO,
+    LIFO
+};
+
+// An open lot; quantity is signed (negative for a short)
+struct Lot {
+    double quantity;
+    double price;
+    Timestamp opened_at;
+};
+
+// Open lots per position, indexed like a PositionBook.
+//
+// Each position keeps its lots in a ring buffer (doubling when full), so
+// FIFO closes from the front and LIFO from the back without shifting or
+// allocating. Every lot is opened once and closed once, so a fill costs
+// amortized O(1) however many lots it spans. A fill larger than the
+// position closes every lot and opens the remainder on the other side.
+class LotLedger {
+public:
+    explicit LotLedger(LotMethod method = LotMethod::FIFO) : method_(method) {}
+
+    LotMethod method() const { return method_; }
+
+    // Applies a signed fill to position i and returns the P&L it realized
+    double apply(SymbolIndex i, double quantity, double price, Timestamp timestamp);
+
+    double quantity(SymbolIndex i) const { return i < rings_.size() ? rings_[i].quantity : 0.0; }
+    double cost_basis(SymbolIndex i) const { return i < rings_.size() ? rings_[i].cost : 0.0; }
+    double avg_entry_price(SymbolIndex i) const;
+    size_t num_lots(SymbolIndex i) const { return i < rings_.size() ? rings_[i].size : 0; }
+
+    // Calls fn(const Lot&) for each open lot of position i, oldest first
+    template<typename Fn>
+    void for_each_lot(SymbolIndex i, Fn&& fn) const {
+        if (i >= rings_.size()) return;
+        const Ring& ring = rings_[i];
+        for (uint32_t k = 0; k < ring.size; ++k) {
+            fn(ring.at(ring.head + k));
+        }
+    }
+
+    void clear() { rings_.clear(); }
+
+    void save_state(utils::BinaryWriter& out) const;
+    void load_state(utils::BinaryReader& in);
+
+private:
+    struct Ring {
+        std::vector<Lot> lots;      // capacity is a power of two
+        uint32_t head = 0;
+        uint32_t size = 0;
+        double quantity = 0.0;
+        double cost = 0.0;          // sum of quantity * price over open lots
+
+        Lot& at(uint32_t k) { return lots[k & (lots.size() - 1)]; }
+        const Lot& at(uint32_t k) const { return lots[k & (lots.size() - 1)]; }
+        void push(const Lot& lot);
+    };
+
+    LotMethod method_;
+    std::vector<Ring> rings_;
+};
+
+} // namespace portfolio
+} // namespace quantflow
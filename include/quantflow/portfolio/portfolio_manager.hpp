@@ -1,62 +1,143 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include "quantflow/portfolio/lot_ledger.hpp"
+#include "quantflow/portfolio/portfolio_snapshot.hpp"
+#include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 namespace quantflow {
 namespace portfolio {
 
+// Positions live in a PositionBook; the PortfolioState returned by
+// get_state() is its mirror, brought up to date when read. Fills are
+// matched against open lots (FIFO or LIFO) for realized P&L and entry
+// prices, so shorts and flips through zero are accounted for.
+//
+// Equity is cash plus the book's running market value, which fills and
+// price updates adjust by their delta, so a price update costs O(symbols
+// updated) rather than O(positions held). Every resync_interval price
+// updates the sum is recomputed exactly to bound rounding drift.
+//
+// Positions are stamped with the time of the update that touched them:
+// the fill's timestamp, or the one passed with prices. Price updates that
+// pass none use the latest time the manager has seen (state last_updated).
+//
+// The owning thread calls publish_snapshot() to hand a consistent copy of
+// cash, equity and positions to readers on other threads via snapshots().
 class PortfolioManager {
 public:
-    explicit PortfolioManager(double initial_cash)
-        : state_{} {
+    explicit PortfolioManager(double initial_cash, size_t resync_interval = 4096,
+                              size_t snapshot_capacity = 4096,
+                              LotMethod lot_method = LotMethod::FIFO)
+        : state_{},
+          book_(&state_.positions),
+          lots_(lot_method),
+          snapshots_(snapshot_capacity),
+          resync_interval_(resync_interval),
+          updates_since_resync_(0) {
         state_.cash = initial_cash;
         state_.equity = initial_cash;
         state_.buying_power = initial_cash;
     }
     
+    // The book points into state_
+    PortfolioManager(const PortfolioManager&) = delete;
+    PortfolioManager& operator=(const PortfolioManager&) = delete;
+    
     void update_position(const Fill& fill) {
-        auto& pos = state_.positions[fill.symbol];
+        SymbolIndex pos = book_.index(fill.symbol);
+        bool buy = fill.side == OrderSide::BUY || fill.side == OrderSide::COVER;
+        double signed_quantity = buy ? fill.quantity : -fill.quantity;
+        advance_clock(fill.timestamp);
+        
+        book_.add_realized_pnl(pos, lots_.apply(pos, signed_quantity, fill.price, fill.timestamp));
+        book_.set_quantity(pos, lots_.quantity(pos), state_.last_updated);
+        book_.set_avg_entry_price(pos, lots_.avg_entry_price(pos));
+        book_.add_commission(pos, fill.commission);
         
-        if (fill.side == OrderSide::BUY) {
-            double new_qty = pos.quantity + fill.quantity;
-            pos.avg_entry_price = ((pos.avg_entry_price * pos.quantity) +
-                                   (fill.price * fill.quantity)) / new_qty;
-            pos.quantity = new_qty;
+        if (buy) {
             state_.cash -= fill.total_cost();
         } else {
-            pos.quantity -= fill.quantity;
-            double pnl = (fill.price - pos.avg_entry_price) * fill.quantity;
-            pos.realized_pnl += pnl;
             state_.cash += fill.notional() - fill.commission;
         }
-        
-        pos.total_commission += fill.commission;
     }
     
-    void update_prices(const std::unordered_map<Symbol, double>& prices) {
-        for (auto& [symbol, pos] : state_.positions) {
-            auto it = prices.find(symbol);
-            if (it != prices.end()) {
-                pos.current_price = it->second;
-                pos.unrealized_pnl = (pos.current_price - pos.avg_entry_price) * pos.quantity;
-            }
+    void update_prices(const std::unordered_map<Symbol, double>& prices, Timestamp timestamp = 0) {
+        advance_clock(timestamp);
+        for (const auto& [symbol, price] : prices) {
+            apply_price(symbol, price);
         }
-        
-        state_.equity = state_.cash;
-        for (const auto& [sym, pos] : state_.positions) {
-            state_.equity += pos.market_value();
+        state_.equity = state_.cash + book_.market_value();
+    }
+    
+    void update_price(const Symbol& symbol, double price, Timestamp timestamp = 0) {
+        advance_clock(timestamp);
+        apply_price(symbol, price);
+        state_.equity = state_.cash + book_.market_value();
+    }
+    
+    // Marks every position at once; prices[i] belongs to symbol index i
+    void mark_to_market(const std::vector<double>& prices, Timestamp timestamp = 0) {
+        if (prices.size() < book_.size()) {
+            throw std::invalid_argument("mark_to_market needs a price for every symbol index");
         }
+        advance_clock(timestamp);
+        book_.mark_all(prices.data(), state_.last_updated);
+        updates_since_resync_ = 0;
+        state_.equity = state_.cash + book_.market_value();
+    }
+    
+    SymbolIndex symbol_index(const Symbol& symbol) { return book_.index(symbol); }
+    const PositionBook& positions() const { return book_; }
+    const LotLedger& lots() const { return lots_; }
+    size_t num_positions() const { return book_.num_open(); }
+    
+    void publish_snapshot(Timestamp timestamp) {
+        snapshots_.publish(book_, state_.cash, state_.equity, timestamp);
+    }
+    
+    const SnapshotPublisher& snapshots() const { return snapshots_; }
+    
+    const PortfolioState& get_state() const {
+        book_.sync_view();
+        return state_;
     }
     
-    const PortfolioState& get_state() const { return state_; }
     const Position* get_position(const Symbol& symbol) const {
-        auto it = state_.positions.find(symbol);
-        return (it != state_.positions.end()) ? &it->second : nullptr;
+        SymbolIndex pos;
+        if (!book_.find(symbol, pos)) return nullptr;
+        book_.sync_view();
+        return &book_.view(pos);
     }
 
 private:
     PortfolioState state_;
+    mutable PositionBook book_;     // syncing the view is not a logical change
+    LotLedger lots_;                // indexed like book_
+    SnapshotPublisher snapshots_;
+    size_t resync_interval_;
+    size_t updates_since_resync_;
+    
+    void advance_clock(Timestamp timestamp) {
+        if (timestamp != 0) {
+            state_.last_updated = timestamp;
+        }
+    }
+    
+    void apply_price(const Symbol& symbol, double price) {
+        SymbolIndex pos;
+        if (book_.find(symbol, pos)) {
+            book_.mark(pos, price, state_.last_updated);
+        }
+        
+        if (resync_interval_ > 0 && ++updates_since_resync_ >= resync_interval_) {
+            updates_since_resync_ = 0;
+            book_.resync();
+        }
+    }
 };
 
 } // namespace portfolio
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace quantflow {
+namespace portfolio {
+
+struct PositionSnapshot {
+    SymbolIndex symbol;
+    double quantity;
+    double avg_entry_price;
+    double current_price;
+    double realized_pnl;
+    double total_commission;
+
+    double market_value() const { return quantity * current_price; }
+    double unrealized_pnl() const { return quantity * (current_price - avg_entry_price); }
+};
+
+// Consistent copy of a portfolio at one publish; positions are the
+// non-flat ones in symbol index order. Symbol indices belong to the book
+// generation the snapshot was taken from, and symbol() resolves them in
+// that generation's name table, which outlives the snapshot.
+struct PortfolioSnapshot {
+    uint64_t version = 0;           // 0 = nothing published yet
+    uint64_t generation = 0;        // PositionBook::generation() at publish
+    Timestamp timestamp = 0;
+    double cash = 0.0;
+    double equity = 0.0;
+    bool truncated = false;         // open positions past capacity() left out
+    std::vector<PositionSnapshot> positions;
+    const Symbol* names = nullptr;
+
+    const Symbol& symbol(SymbolIndex i) const { return names[i]; }
+};
+
+// Hands portfolio state from the thread that owns it to any number of
+// reader threads without locks.
+//
+// The writer fills the slot readers are not pointed at, under that slot's
+// sequence counter, then flips the current slot. A reader copies the
+// current slot and retries if its counter moved during the copy, which
+// only happens when the writer publishes twice within a single read, so
+// the writer never waits and readers rarely spin.
+//
+// Slots are preallocated for max_symbols symbol indices, and cash and
+// equity always cover the whole book. Open positions at higher indices
+// are left out and the snapshot is marked truncated: readers may hold a
+// slot at any time, so it can never be reallocated. Symbol names go into
+// an append-only table before the snapshot that first uses them. Clearing
+// the book starts a new generation whose indices may name other symbols,
+// so the next publish starts a new table; earlier tables are kept for the
+// publisher's lifetime, since a reader may still hold a snapshot of theirs.
+class SnapshotPublisher {
+public:
+    explicit SnapshotPublisher(size_t max_symbols = 4096);
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Owning thread only
+    void publish(const PositionBook& book, double cash, double equity, Timestamp timestamp);
+
+    // Any thread; false until the first publish
+    bool read(PortfolioSnapshot& snapshot) const;
+
+    uint64_t version() const { return version_.load(std::memory_order_acquire); }
+    size_t capacity() const { return max_symbols_; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};      // odd while being written
+        uint64_t version = 0;
+        uint64_t generation = 0;
+        const Symbol* names = nullptr;
+        Timestamp timestamp = 0;
+        double cash = 0.0;
+        double equity = 0.0;
+        bool truncated = false;
+        size_t num_positions = 0;
+        std::vector<PositionSnapshot> positions;
+    };
+
+    size_t max_symbols_;
+    Slot slots_[2];
+    std::atomic<uint32_t> current_;
+    std::atomic<uint64_t> version_;
+
+    // One name table per book generation; only the last one still grows
+    std::vector<std::unique_ptr<Symbol[]>> names_;
+    uint64_t generation_;
+    size_t num_names_;
+};
+
+} // namespace portfolio
+} // namespace quantflow
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/utils/bits.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+namespace portfolio {
+
+using SymbolIndex = uint32_t;
+
+// Positions stored field by field in contiguous arrays indexed by a dense
+// SymbolIndex, handed out in first-seen order. A bitset tracks non-flat
+// positions and the total market value is kept incrementally, so counting
+// positions and valuing the book are O(1) and mark_all() is one vectorized
+// pass over the price and quantity arrays.
+//
+// For code written against PortfolioState, the book can mirror itself into
+// a position map: entries are created as symbols are indexed, and
+// sync_view() copies over the positions changed since the last sync.
+class PositionBook {
+public:
+    explicit PositionBook(std::unordered_map<Symbol, Position>* view = nullptr)
+        : view_(view), market_value_(0.0), num_open_(0), generation_(next_generation()) {}
+
+    // Index of a symbol, adding a flat position the first time
+    SymbolIndex index(const Symbol& symbol);
+    bool find(const Symbol& symbol, SymbolIndex& index) const;
+
+    size_t size() const { return symbols_.size(); }
+    const Symbol& symbol(SymbolIndex i) const { return symbols_[i]; }
+
+    // Unique across books and renewed by clear(): indices cached from a
+    // book stay valid while its generation is unchanged
+    uint64_t generation() const { return generation_; }
+
+    double quantity(SymbolIndex i) const { return quantity_[i]; }
+    double avg_entry_price(SymbolIndex i) const { return avg_entry_price_[i]; }
+    double current_price(SymbolIndex i) const { return current_price_[i]; }
+    double unrealized_pnl(SymbolIndex i) const { return unrealized_pnl_[i]; }
+    double realized_pnl(SymbolIndex i) const { return realized_pnl_[i]; }
+    double total_commission(SymbolIndex i) const { return total_commission_[i]; }
+    double market_value(SymbolIndex i) const { return quantity_[i] * current_price_[i]; }
+    bool is_open(SymbolIndex i) const { return (open_bits_[i >> 6] >> (i & 63)) & 1; }
+
+    const double* quantities() const { return quantity_.data(); }
+    const double* avg_entry_prices() const { return avg_entry_price_.data(); }
+    const double* current_prices() const { return current_price_.data(); }
+
+    // Fills and marks stamp last_updated with `now`; a position opening
+    // from flat (or flipping side) also takes it as opened_at
+    void set_quantity(SymbolIndex i, double quantity, Timestamp now);
+    void set_avg_entry_price(SymbolIndex i, double price);
+    void add_realized_pnl(SymbolIndex i, double pnl);
+    void add_commission(SymbolIndex i, double commission);
+
+    // Marks one position, or every position from prices[0, size())
+    void mark(SymbolIndex i, double price, Timestamp now);
+    void mark_all(const double* prices, Timestamp now);
+
+    double market_value() const { return market_value_; }
+    size_t num_open() const { return num_open_; }
+
+    // Puts back a checkpointed running total as is
+    void set_market_value(double value) { market_value_ = value; }
+
+    // Re-sums the running market value exactly
+    void resync();
+
+    // Calls fn(index) for each non-flat position in index order
+    template<typename Fn>
+    void for_each_open(Fn&& fn) const {
+        for (size_t word = 0; word < open_bits_.size(); ++word) {
+            uint64_t bits = open_bits_[word];
+            while (bits) {
+                fn(static_cast<SymbolIndex>((word << 6) + utils::lowest_bit(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    Position position(SymbolIndex i) const;
+
+    // Loads a full position (checkpoint restore), indexing it if needed
+    void restore(const Position& position);
+
+    // Mirror entry of an indexed symbol (only with a view attached)
+    const Position& view(SymbolIndex i) const { return *views_[i]; }
+    void sync_view();
+    void clear();
+
+private:
+    std::unordered_map<Symbol, Position>* view_;
+    std::unordered_map<Symbol, SymbolIndex> indices_;
+    std::vector<Symbol> symbols_;
+
+    std::vector<double> quantity_;
+    std::vector<double> avg_entry_price_;
+    std::vector<double> current_price_;
+    std::vector<double> unrealized_pnl_;
+    std::vector<double> realized_pnl_;
+    std::vector<double> total_commission_;
+    std::vector<Timestamp> opened_at_;
+    std::vector<Timestamp> last_updated_;
+
+    std::vector<uint64_t> open_bits_;
+    double market_value_;
+    size_t num_open_;
+    uint64_t generation_;
+
+    // View entries (map nodes never move) and the indices they lag behind on
+    std::vector<Position*> views_;
+    std::vector<SymbolIndex> dirty_;
+    std::vector<uint8_t> is_dirty_;
+
+    static uint64_t next_generation();
+
+    void touch(SymbolIndex i) {
+        if (view_ && !is_dirty_[i]) {
+            is_dirty_[i] = 1;
+            dirty_.push_back(i);
+        }
+    }
+};
+
+} // namespace portfolio
+} // namespace quantflow
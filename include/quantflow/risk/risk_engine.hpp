@@ -0,0 +1,85 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/utils/name_index.hpp"
+#include <vector>
+
+namespace quantflow {
+namespace risk {
+
+struct RiskEngineConfig {
+    size_t window = 250;            // returns kept per symbol
+    double confidence = 0.99;       // VaR / ES level
+    size_t block_size = 64;         // columns per cache block in the update
+};
+
+// Losses are positive amounts in the exposures' currency, over one period
+struct RiskReport {
+    double volatility = 0.0;        // std dev of portfolio P&L
+    double parametric_var = 0.0;
+    double parametric_es = 0.0;
+    double historical_var = 0.0;
+    double historical_es = 0.0;
+    size_t observations = 0;
+};
+
+// Rolling covariance of per-period returns over a fixed universe, with
+// parametric (normal) and historical VaR / expected shortfall of a set of
+// dollar exposures on demand.
+//
+// Each period adds one cross-section of returns and drops the oldest, as a
+// single rank-2 update of the running cross-product sums: upper triangle
+// only, swept in column blocks that stay in L1, AVX2 when available. The
+// sums are recomputed exactly from the stored window once per window to
+// bound rounding drift. A report costs O(N^2 + window * N).
+class RiskEngine {
+public:
+    explicit RiskEngine(const std::vector<Symbol>& universe, const RiskEngineConfig& config = {});
+
+    size_t size() const { return symbols_.size(); }
+    bool find(const Symbol& symbol, size_t& index) const { return index_.find(symbol, index); }
+    const Symbol& symbol(size_t index) const { return symbols_[index]; }
+
+    // Adds one period of returns, returns[i] for symbol i
+    void update(const double* returns);
+
+    // Price-driven form: record closes with mark(), then close_period()
+    // turns them into returns against the previous period's closes.
+    // Symbols not marked in a period contribute a zero return.
+    void mark(size_t index, double price) { pending_[index] = price; }
+    void close_period();
+
+    size_t count() const { return count_; }
+    double mean(size_t i) const;
+    double covariance(size_t i, size_t j) const;
+
+    RiskReport report(const double* exposures) const;
+    RiskReport report(const PortfolioState& portfolio) const;
+
+private:
+    RiskEngineConfig config_;
+    std::vector<Symbol> symbols_;
+    utils::NameIndex index_;
+
+    size_t stride_;                 // row length, padded to whole vectors
+    std::vector<double> cross_;     // sum of r_i * r_j, upper triangle used
+    std::vector<double> sum_;
+    std::vector<double> window_;    // ring of return rows
+    std::vector<double> zeros_;
+    size_t head_;                   // next row to write
+    size_t count_;
+    size_t updates_since_resync_;
+
+    std::vector<double> last_;      // previous period's closes
+    std::vector<double> pending_;
+    std::vector<double> returns_;   // the period being added, padded to stride_
+    bool primed_;
+
+    void push_returns();
+    void rank2_update(const double* add, const double* remove);
+    void resync();
+    double portfolio_variance(const double* exposures) const;
+};
+
+} // namespace risk
+} // namespace quantflow
@@ -1,37 +1,63 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/risk/risk_rules.hpp"
+#include <cmath>
 
 namespace quantflow {
 namespace risk {
 
-struct RiskLimits {
-    double max_position_size = 10000.0;
-    double max_portfolio_leverage = 2.0;
-    double max_drawdown_pct = 20.0;
-    double max_loss_per_trade = 500.0;
-};
-
-class RiskManager {
+// Pre-trade checks through a compile-time rule pipeline over exposure
+// aggregates that on_fill / mark keep current. Resolve symbols and
+// strategies to indices once (make_order) and check() costs only the rules.
+template<typename Pipeline = DefaultRiskPipeline>
+class BasicRiskManager {
 public:
-    explicit RiskManager(const RiskLimits& limits)
+    explicit BasicRiskManager(const RiskLimits& limits)
         : limits_(limits) {}
     
+    // An order with no price (a market order on a symbol never marked) has
+    // no notional for the rules to check, so it is rejected outright
+    RiskCheck check(const RiskOrder& order) const {
+        if (!(order.price > 0.0)) return RiskCheck::NO_PRICE;
+        return Pipeline::check(order, exposure_, limits_);
+    }
+    
+    RiskCheck check(const Order& order) {
+        return check(make_order(order));
+    }
+    
+    // Cash, equity and positions are taken from the portfolio for this check
     bool validate_order(const Order& order, const PortfolioState& portfolio) {
-        // Check position size
-        if (order.quantity * order.price > limits_.max_position_size) {
-            return false;
-        }
-        
-        // Check available cash
-        if (order.is_buy()) {
-            double cost = order.quantity * order.price;
-            if (cost > portfolio.cash) {
-                return false;
-            }
-        }
-        
-        return true;
+        exposure_.set_positions(portfolio);
+        exposure_.set_cash(portfolio.cash);
+        exposure_.set_equity(portfolio.equity);
+        return check(order) == RiskCheck::PASS;
+    }
+    
+    // Market orders are priced at the symbol's last mark (0 if it has none)
+    RiskOrder make_order(const Order& order) {
+        RiskOrder risk_order;
+        risk_order.symbol = exposure_.symbol_index(order.symbol);
+        risk_order.strategy = exposure_.strategy_index(order.strategy_id);
+        risk_order.side = order.side;
+        risk_order.quantity = order.quantity;
+        risk_order.price = (order.price > 0.0) ? order.price : exposure_.price(risk_order.symbol);
+        risk_order.stop_price = order.stop_price;
+        return risk_order;
+    }
+    
+    void on_fill(const Fill& fill, const StrategyID& strategy_id = {}) {
+        exposure_.on_fill(exposure_.symbol_index(fill.symbol), exposure_.strategy_index(strategy_id),
+                          fill.side, fill.quantity, fill.price, fill.commission);
+    }
+    
+    void mark(const Symbol& symbol, double price) {
+        exposure_.mark(exposure_.symbol_index(symbol), price);
+    }
+    
+    void update_equity(double equity) {
+        exposure_.set_equity(equity);
     }
     
     double calculate_position_size(
@@ -47,10 +73,17 @@ public:
         
         return risk_amount / risk_per_share;
     }
+    
+    const RiskLimits& limits() const { return limits_; }
+    RiskExposure& exposure() { return exposure_; }
+    const RiskExposure& exposure() const { return exposure_; }
 
 private:
     RiskLimits limits_;
+    RiskExposure exposure_;
 };
 
+using RiskManager = BasicRiskManager<>;
+
 } // namespace risk
 } // namespace quantflow
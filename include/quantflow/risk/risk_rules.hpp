@@ -0,0 +1,318 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+namespace risk {
+
+using portfolio::SymbolIndex;
+
+struct RiskLimits {
+    double max_position_size = 10000.0;     // per-order notional
+    double max_portfolio_leverage = 2.0;    // gross exposure / equity
+    double max_drawdown_pct = 20.0;         // from peak equity; halts new risk
+    double max_loss_per_trade = 500.0;      // quantity * |price - stop|, orders with a stop
+
+    // Default caps, overridable per symbol / strategy (0 = uncapped)
+    double max_symbol_exposure = 0.0;
+    double max_strategy_exposure = 0.0;
+};
+
+enum class RiskCheck : uint8_t {
+    PASS,
+    ORDER_SIZE,
+    CASH,
+    LEVERAGE,
+    DRAWDOWN,
+    LOSS_PER_TRADE,
+    SYMBOL_EXPOSURE,
+    STRATEGY_EXPOSURE,
+    NO_PRICE
+};
+
+inline const char* to_string(RiskCheck check) {
+    switch (check) {
+        case RiskCheck::PASS: return "PASS";
+        case RiskCheck::ORDER_SIZE: return "ORDER_SIZE";
+        case RiskCheck::CASH: return "CASH";
+        case RiskCheck::LEVERAGE: return "LEVERAGE";
+        case RiskCheck::DRAWDOWN: return "DRAWDOWN";
+        case RiskCheck::LOSS_PER_TRADE: return "LOSS_PER_TRADE";
+        case RiskCheck::SYMBOL_EXPOSURE: return "SYMBOL_EXPOSURE";
+        case RiskCheck::STRATEGY_EXPOSURE: return "STRATEGY_EXPOSURE";
+        case RiskCheck::NO_PRICE: return "NO_PRICE";
+    }
+    return "UNKNOWN";
+}
+
+// Order as the rules see it: strings resolved to dense indices and the
+// price filled in for market orders
+struct RiskOrder {
+    SymbolIndex symbol;
+    uint32_t strategy;
+    OrderSide side;
+    double quantity;
+    double price;
+    double stop_price;      // 0 = none
+
+    bool is_buy() const { return side == OrderSide::BUY || side == OrderSide::COVER; }
+    double notional() const { return quantity * price; }
+    double signed_quantity() const { return is_buy() ? quantity : -quantity; }
+};
+
+// Aggregates the rules read, kept current as fills and marks arrive so a
+// check is a handful of array loads and compares.
+//
+// Symbol and gross exposure are revalued on every mark; per-strategy
+// exposure is valued at each strategy's latest fill price in the symbol.
+class RiskExposure {
+public:
+    RiskExposure()
+        : gross_exposure_(0.0), cash_(0.0), equity_(0.0), peak_equity_(0.0) {}
+
+    SymbolIndex symbol_index(const Symbol& symbol) {
+        auto [it, inserted] = symbols_.emplace(symbol, static_cast<SymbolIndex>(position_.size()));
+        if (inserted) {
+            position_.push_back(0.0);
+            price_.push_back(0.0);
+            symbol_limit_.push_back(-1.0);
+        }
+        return it->second;
+    }
+
+    uint32_t strategy_index(const StrategyID& strategy) {
+        auto [it, inserted] = strategies_.emplace(strategy, static_cast<uint32_t>(strategy_exposure_.size()));
+        if (inserted) {
+            strategy_exposure_.push_back(0.0);
+            strategy_limit_.push_back(-1.0);
+        }
+        return it->second;
+    }
+
+    // Override the default caps (a negative cap restores the default)
+    void set_symbol_limit(SymbolIndex symbol, double cap) { symbol_limit_[symbol] = cap; }
+    void set_strategy_limit(uint32_t strategy, double cap) { strategy_limit_[strategy] = cap; }
+
+    void on_fill(SymbolIndex symbol, uint32_t strategy, OrderSide side,
+                 double quantity, double price, double commission) {
+        bool buy = side == OrderSide::BUY || side == OrderSide::COVER;
+        double signed_qty = buy ? quantity : -quantity;
+
+        mark(symbol, price);
+        gross_exposure_ -= std::abs(position_[symbol]) * price;
+        position_[symbol] += signed_qty;
+        gross_exposure_ += std::abs(position_[symbol]) * price;
+        cash_ -= signed_qty * price + commission;
+
+        StrategyHolding& holding = holdings_[key(strategy, symbol)];
+        holding.quantity += signed_qty;
+        double value = std::abs(holding.quantity) * price;
+        strategy_exposure_[strategy] += value - holding.value;
+        holding.value = value;
+    }
+
+    void mark(SymbolIndex symbol, double price) {
+        gross_exposure_ += std::abs(position_[symbol]) * (price - price_[symbol]);
+        price_[symbol] = price;
+    }
+
+    // Take every position from the portfolio, marking at its current price
+    // where it has one; symbols the portfolio does not hold become flat.
+    // Per-strategy holdings only come from on_fill and are left alone.
+    void set_positions(const PortfolioState& portfolio) {
+        std::fill(position_.begin(), position_.end(), 0.0);
+        gross_exposure_ = 0.0;
+        for (const auto& [symbol, held] : portfolio.positions) {
+            SymbolIndex index = symbol_index(symbol);
+            if (held.current_price > 0.0) {
+                price_[index] = held.current_price;
+            }
+            position_[index] = held.quantity;
+            gross_exposure_ += std::abs(held.quantity) * price_[index];
+        }
+    }
+
+    void set_cash(double cash) { cash_ = cash; }
+    void set_equity(double equity) {
+        equity_ = equity;
+        peak_equity_ = std::max(peak_equity_, equity);
+    }
+
+    double position(SymbolIndex symbol) const { return position_[symbol]; }
+    double price(SymbolIndex symbol) const { return price_[symbol]; }
+    double symbol_exposure(SymbolIndex symbol) const { return std::abs(position_[symbol]) * price_[symbol]; }
+    double strategy_exposure(uint32_t strategy) const { return strategy_exposure_[strategy]; }
+    double gross_exposure() const { return gross_exposure_; }
+    double cash() const { return cash_; }
+    double equity() const { return equity_; }
+    double peak_equity() const { return peak_equity_; }
+
+    double drawdown_pct() const {
+        return (peak_equity_ > 0.0) ? (peak_equity_ - equity_) / peak_equity_ * 100.0 : 0.0;
+    }
+
+    double symbol_limit(SymbolIndex symbol, const RiskLimits& limits) const {
+        return symbol_limit_[symbol] >= 0.0 ? symbol_limit_[symbol] : limits.max_symbol_exposure;
+    }
+    double strategy_limit(uint32_t strategy, const RiskLimits& limits) const {
+        return strategy_limit_[strategy] >= 0.0 ? strategy_limit_[strategy] : limits.max_strategy_exposure;
+    }
+
+    // True when the order only shrinks the position, never flips it
+    bool reduces(const RiskOrder& order) const {
+        double held = position_[order.symbol];
+        return (held > 0.0 && !order.is_buy() && order.quantity <= held) ||
+               (held < 0.0 && order.is_buy() && order.quantity <= -held);
+    }
+
+    // True when the order only shrinks its strategy's holding in the symbol
+    bool reduces_holding(const RiskOrder& order) const {
+        double held = holding(order.strategy, order.symbol).quantity;
+        return (held > 0.0 && !order.is_buy() && order.quantity <= held) ||
+               (held < 0.0 && order.is_buy() && order.quantity <= -held);
+    }
+
+    // Strategy exposure if the order filled at its price
+    double strategy_exposure_after(const RiskOrder& order) const {
+        const StrategyHolding& held = holding(order.strategy, order.symbol);
+        return strategy_exposure_[order.strategy] - held.value +
+               std::abs(held.quantity + order.signed_quantity()) * order.price;
+    }
+
+    // Gross exposure if the order filled at its price
+    double gross_after(const RiskOrder& order) const {
+        double held = position_[order.symbol];
+        return gross_exposure_ - std::abs(held) * price_[order.symbol] +
+               std::abs(held + order.signed_quantity()) * order.price;
+    }
+
+private:
+    struct StrategyHolding {
+        double quantity = 0.0;
+        double value = 0.0;
+    };
+
+    static uint64_t key(uint32_t strategy, SymbolIndex symbol) {
+        return (static_cast<uint64_t>(strategy) << 32) | symbol;
+    }
+
+    const StrategyHolding& holding(uint32_t strategy, SymbolIndex symbol) const {
+        static const StrategyHolding none;
+        auto it = holdings_.find(key(strategy, symbol));
+        return (it != holdings_.end()) ? it->second : none;
+    }
+
+    std::unordered_map<Symbol, SymbolIndex> symbols_;
+    std::unordered_map<StrategyID, uint32_t> strategies_;
+
+    std::vector<double> position_;
+    std::vector<double> price_;
+    std::vector<double> symbol_limit_;
+    std::vector<double> strategy_exposure_;
+    std::vector<double> strategy_limit_;
+    std::unordered_map<uint64_t, StrategyHolding> holdings_;
+
+    double gross_exposure_;
+    double cash_;
+    double equity_;
+    double peak_equity_;
+};
+
+// Rules are stateless types with a static check(); RiskPipeline chains
+// them at compile time and stops at the first rejection, so a pipeline
+// compiles to straight-line code with no virtual calls.
+
+struct DrawdownRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits& limits) {
+        // Past the limit only risk-reducing orders go through
+        return (limits.max_drawdown_pct > 0.0 &&
+                exposure.drawdown_pct() >= limits.max_drawdown_pct &&
+                !exposure.reduces(order)) ? RiskCheck::DRAWDOWN : RiskCheck::PASS;
+    }
+};
+
+struct OrderSizeRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure&,
+                           const RiskLimits& limits) {
+        return (order.notional() > limits.max_position_size) ? RiskCheck::ORDER_SIZE : RiskCheck::PASS;
+    }
+};
+
+struct LossPerTradeRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure&,
+                           const RiskLimits& limits) {
+        if (order.stop_price <= 0.0 || limits.max_loss_per_trade <= 0.0) return RiskCheck::PASS;
+        double loss = order.quantity * std::abs(order.price - order.stop_price);
+        return (loss > limits.max_loss_per_trade) ? RiskCheck::LOSS_PER_TRADE : RiskCheck::PASS;
+    }
+};
+
+struct CashRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits&) {
+        return (order.is_buy() && order.notional() > exposure.cash()) ? RiskCheck::CASH : RiskCheck::PASS;
+    }
+};
+
+struct SymbolExposureRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits& limits) {
+        double cap = exposure.symbol_limit(order.symbol, limits);
+        if (cap <= 0.0 || exposure.reduces(order)) return RiskCheck::PASS;
+
+        double after = std::abs(exposure.position(order.symbol) + order.signed_quantity()) * order.price;
+        return (after > cap) ? RiskCheck::SYMBOL_EXPOSURE : RiskCheck::PASS;
+    }
+};
+
+struct StrategyExposureRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits& limits) {
+        double cap = exposure.strategy_limit(order.strategy, limits);
+        if (cap <= 0.0 || exposure.reduces_holding(order)) return RiskCheck::PASS;
+
+        double after = exposure.strategy_exposure_after(order);
+        return (after > cap) ? RiskCheck::STRATEGY_EXPOSURE : RiskCheck::PASS;
+    }
+};
+
+struct LeverageRule {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits& limits) {
+        if (limits.max_portfolio_leverage <= 0.0 || exposure.reduces(order)) return RiskCheck::PASS;
+        if (exposure.equity() <= 0.0) return RiskCheck::LEVERAGE;
+
+        double leverage = exposure.gross_after(order) / exposure.equity();
+        return (leverage > limits.max_portfolio_leverage) ? RiskCheck::LEVERAGE : RiskCheck::PASS;
+    }
+};
+
+template<typename... Rules>
+struct RiskPipeline {
+    static RiskCheck check(const RiskOrder& order, const RiskExposure& exposure,
+                           const RiskLimits& limits) {
+        RiskCheck result = RiskCheck::PASS;
+        (((result = Rules::check(order, exposure, limits)) == RiskCheck::PASS) && ...);
+        return result;
+    }
+};
+
+// Cheap, order-only rules run first
+using DefaultRiskPipeline = RiskPipeline<
+    OrderSizeRule,
+    LossPerTradeRule,
+    CashRule,
+    DrawdownRule,
+    SymbolExposureRule,
+    StrategyExposureRule,
+    LeverageRule
+>;
+
+} // namespace risk
+} // namespace quantflow
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/utils/name_index.hpp"
+#include "quantflow/utils/span.hpp"
+#include "quantflow/utils/thread_pool.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace quantflow {
+namespace strategy {
+
+struct CrossSectionConfig {
+    size_t num_quantiles = 5;
+    // Threads compute() runs on. With at least as many factors as threads
+    // whole factors run concurrently; otherwise, for universes of
+    // split_threshold symbols or more, each factor is split across them
+    size_t threads = 1;
+    size_t split_threshold = 16384;
+};
+
+// Factor values for a fixed universe, ranked across symbols once per
+// timestamp. Each factor is a column: one contiguous array of values
+// indexed by symbol, written in place as signals update, and matching
+// columns of results.
+//
+// compute() ranks every factor (ties share their average rank), turns
+// values into z-scores and ranks into quantile buckets (0 = lowest).
+// Factors are independent, so they are spread over a thread pool. When
+// there are fewer factors than threads and the universe is large, each
+// factor is instead cut into one symbol range per thread: the ranges are
+// gathered, z-scored and sorted in parallel, merged pairwise in parallel
+// rounds, and only the final tie pass runs on one thread. Missing values
+// (NaN) are left out of the statistics: their rank and z-score are NaN and
+// their bucket is -1.
+class CrossSection {
+public:
+    CrossSection(const std::vector<Symbol>& universe, const std::vector<std::string>& factors,
+                 const CrossSectionConfig& config = {});
+
+    size_t num_symbols() const { return symbols_.size(); }
+    size_t num_factors() const { return factors_.size(); }
+    const Symbol& symbol(size_t i) const { return symbols_[i]; }
+    const std::string& factor_name(size_t f) const { return factors_[f]; }
+    bool find(const Symbol& symbol, size_t& index) const { return index_.find(symbol, index); }
+    size_t factor(const std::string& name) const;
+
+    // Input column of a factor; every value starts out missing
+    utils::Span<double> values(size_t f) { return {&values_[f * stride()], num_symbols()}; }
+    void set(size_t f, size_t symbol, double value) { values_[f * stride() + symbol] = value; }
+    void clear(size_t f);
+
+    void compute(Timestamp timestamp);
+    Timestamp timestamp() const { return timestamp_; }
+
+    // Results of the last compute(), valid until the next one
+    utils::Span<const double> ranks(size_t f) const { return {&ranks_[f * stride()], num_symbols()}; }
+    utils::Span<const double> zscores(size_t f) const { return {&zscores_[f * stride()], num_symbols()}; }
+    utils::Span<const int32_t> buckets(size_t f) const { return {&buckets_[f * stride()], num_symbols()}; }
+    size_t count(size_t f) const { return counts_[f]; }     // symbols with a value
+
+private:
+    // Values travel with their index so the sort compares contiguous keys
+    struct Entry {
+        double value;
+        uint32_t symbol;
+    };
+
+    CrossSectionConfig config_;
+    std::vector<Symbol> symbols_;
+    utils::NameIndex index_;
+    std::vector<std::string> factors_;
+
+    std::vector<double> values_;
+    std::vector<double> ranks_;
+    std::vector<double> zscores_;
+    std::vector<int32_t> buckets_;
+    std::vector<size_t> counts_;
+    std::vector<Entry> order_;      // per-factor sort scratch
+    Timestamp timestamp_;
+
+    std::unique_ptr<utils::ThreadPool> pool_;
+
+    // Split path: a second sort buffer and per-range partial results
+    std::vector<Entry> merge_;
+    std::vector<size_t> chunk_count_;
+    std::vector<size_t> chunk_offset_;  // range starts in merge_, plus the end
+    std::vector<double> chunk_sum_;
+    std::vector<double> chunk_squares_;
+
+    size_t stride() const { return symbols_.size(); }
+    bool split_factors() const;
+    void compute_factor(size_t f);
+    void compute_factor_split(size_t f);
+    void assign_ranks(size_t f, const Entry* sorted, size_t m);
+};
+
+} // namespace strategy
+} // namespace quantflow
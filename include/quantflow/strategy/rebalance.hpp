@@ -0,0 +1,74 @@
+#pragma once
+
+#include "quantflow/core/types.hpp"
+#include "quantflow/portfolio/position_book.hpp"
+#include "quantflow/utils/name_index.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace quantflow {
+namespace strategy {
+
+struct OrderRequest;
+
+struct RebalanceConfig {
+    double lot_size = 1.0;          // default lot; trades are whole lots, rounded toward zero
+    double min_trade_value = 0.0;   // skip trades below this notional
+    double min_trade_weight = 0.0;  // ... or below this share of equity
+};
+
+// A fixed list of symbols a strategy rebalances by target weight, with the
+// prices and lot sizes sizing needs, all in arrays indexed like the
+// weights. Strategies keep one, mark() it as bars arrive and pass it to
+// StrategyContext::rebalance.
+//
+// plan() diffs targets against current holdings in one vectorized pass
+// over the arrays and only touches symbols that actually trade when
+// building orders, so a rebalance costs a few ns per symbol.
+class RebalanceUniverse {
+public:
+    explicit RebalanceUniverse(const std::vector<Symbol>& symbols, const RebalanceConfig& config = {});
+
+    size_t size() const { return symbols_.size(); }
+    const Symbol& symbol(size_t i) const { return symbols_[i]; }
+    bool find(const Symbol& symbol, size_t& index) const { return index_.find(symbol, index); }
+
+    void mark(size_t i, double price) { prices_[i] = price; }
+    void set_lot_size(size_t i, double lot_size);
+    double price(size_t i) const { return prices_[i]; }
+    const RebalanceConfig& config() const { return config_; }
+
+    // Current quantity per symbol, filled in before plan()
+    std::vector<double>& holdings() { return holdings_; }
+
+    // Gathers holdings from a position book, caching where each symbol
+    // lives in it while the book and its generation stay the same; symbols
+    // the book has not seen yet count as flat. With `working` (signed
+    // quantity of open orders, indexed like the book) orders still working
+    // count as held, so a second rebalance does not repeat them.
+    void load_holdings(const portfolio::PositionBook& book, const double* working = nullptr);
+
+    // Appends orders taking holdings() to weights[i] * equity at the marked
+    // prices: sells first, then buys. Symbols without a price are left alone.
+    void plan(const double* weights, double equity, std::vector<OrderRequest>& orders);
+
+private:
+    static constexpr uint32_t NOT_HELD = UINT32_MAX;
+
+    RebalanceConfig config_;
+    std::vector<Symbol> symbols_;
+    utils::NameIndex index_;
+
+    std::vector<double> prices_;
+    std::vector<double> lot_sizes_;
+    std::vector<double> holdings_;
+    std::vector<double> deltas_;    // signed, whole-lot quantity to trade
+
+    std::vector<uint32_t> book_index_;
+    const portfolio::PositionBook* book_;   // book_index_ resolves into this book
+    uint64_t book_generation_;              // ... at this generation
+    size_t book_size_;                      // ... when it had this many symbols
+};
+
+} // namespace strategy
+} // namespace quantflow
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "quantflow/core/types.hpp"
+#include "quantflow/strategy/rebalance.hpp"
+#include "quantflow/utils/binary_io.hpp"
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace quantflow {
@@ -9,6 +12,16 @@ namespace strategy {
 
 class StrategyContext;
 
+// An order for StrategyContext::submit_order / submit_orders
+struct OrderRequest {
+    Symbol symbol;
+    OrderSide side;
+    double quantity;
+    OrderType type = OrderType::MARKET;
+    double price = 0.0;         // limit price, LIMIT and STOP_LIMIT
+    double stop_price = 0.0;    // trigger, STOP and STOP_LIMIT
+};
+
 class Strategy {
 public:
     virtual ~Strategy() = default;
@@ -18,6 +31,12 @@ public:
     virtual void on_bar(const Bar& bar) = 0;
     virtual void on_order_update(const Order& order) {}
     virtual void on_fill(const Fill& fill) {}
+    virtual void on_timer(const TimerEvent&) {}
+    
+    // Opt-in checkpoint hooks, called by BacktestEngine::save_checkpoint /
+    // load_checkpoint. on_init is not called again on a resumed run.
+    virtual void save_state(utils::BinaryWriter&) const {}
+    virtual void load_state(utils::BinaryReader&) {}
     
     void set_context(StrategyContext* ctx) { context_ = ctx; }
     
@@ -33,6 +52,39 @@ public:
     virtual OrderID sell(const Symbol& symbol, double quantity, double price = 0.0) = 0;
     virtual void cancel_order(OrderID order_id) = 0;
     
+    // Any order type; buy/sell only place MARKET or LIMIT orders. Throws
+    // std::invalid_argument if a price the type needs is missing.
+    virtual OrderID submit_order(const OrderRequest& request) = 0;
+    
+    // Batch forms for rebalances: the whole batch shares one timestamp and
+    // one ID reservation, and IDs come back in request order
+    virtual std::vector<OrderID> submit_orders(const std::vector<OrderRequest>& requests) = 0;
+    virtual void cancel_orders(const std::vector<OrderID>& order_ids) = 0;
+    
+    // Trades the universe toward weights[i] of equity in symbol i as one
+    // batch (see RebalanceUniverse::plan). This default reads positions
+    // one by one; contexts with a position book gather from it directly.
+    virtual std::vector<OrderID> rebalance(RebalanceUniverse& universe,
+                                           const std::vector<double>& weights) {
+        if (weights.size() != universe.size()) {
+            throw std::invalid_argument("rebalance needs one weight per universe symbol");
+        }
+        auto& holdings = universe.holdings();
+        for (size_t i = 0; i < universe.size(); ++i) {
+            const Position* position = get_position(universe.symbol(i));
+            holdings[i] = position ? position->quantity : 0.0;
+        }
+        
+        std::vector<OrderRequest> orders;
+        universe.plan(weights.data(), get_portfolio().equity, orders);
+        return submit_orders(orders);
+    }
+    
+    // on_timer fires at `when`, then every `interval` ns if interval > 0
+    virtual TimerID schedule_timer(Timestamp when, uint64_t user_data = 0,
+                                   Duration interval = 0) = 0;
+    virtual void cancel_timer(TimerID timer_id) = 0;
+    
     virtual const Position* get_position(const Symbol& symbol) const = 0;
     virtual const PortfolioState& get_portfolio() const = 0;
     virtual double get_cash() const = 0;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace quantflow {
+namespace utils {
+
+// Native-endian binary serialization for checkpoints. Not intended as a
+// portable interchange format.
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::ostream& out) : out_(out) {}
+
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "POD types only");
+        out_.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write_string(const std::string& value) {
+        write<uint64_t>(value.size());
+        out_.write(value.data(), value.size());
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "POD types only");
+        write<uint64_t>(values.size());
+        out_.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    bool good() const { return out_.good(); }
+
+private:
+    std::ostream& out_;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(std::istream& in) : in_(in) {}
+
+    template<typename T>
+    T read() {
+        T value;
+        read(value);
+        return value;
+    }
+
+    template<typename T>
+    void read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "POD types only");
+        in_.read(reinterpret_cast<char*>(&value), sizeof(T));
+        check();
+    }
+
+    std::string read_string() {
+        std::string value(read<uint64_t>(), '\0');
+        in_.read(value.data(), value.size());
+        check();
+        return value;
+    }
+
+    template<typename T>
+    void read_vector(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "POD types only");
+        values.resize(read<uint64_t>());
+        in_.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T));
+        check();
+    }
+
+private:
+    std::istream& in_;
+
+    void check() {
+        if (!in_) {
+            throw std::runtime_error("Unexpected end of binary stream");
+        }
+    }
+};
+
+} // namespace utils
+} // namespace quantflow
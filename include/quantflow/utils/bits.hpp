@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace quantflow {
+namespace utils {
+
+// Index of the lowest set bit; word must be non-zero
+inline int lowest_bit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Index of the highest set bit; word must be non-zero
+inline int highest_bit(uint64_t word) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+} // namespace utils
+} // namespace quantflow
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace quantflow {
+namespace utils {
+
+// Single-producer ring read by several consumers, each of which sees every
+// item in publish order through its own cursor. A slot is reused only once
+// the slowest consumer has moved past it, so a full ring means that
+// consumer is a whole capacity behind.
+//
+// Consumers must be added before the first publish.
+template<typename T>
+class BroadcastRing {
+public:
+    BroadcastRing(size_t capacity, size_t max_consumers)
+        : capacity_(capacity),
+          slots_(new T[capacity]),
+          cursors_(new Cursor[max_consumers]),
+          max_consumers_(max_consumers),
+          num_consumers_(0),
+          head_(0),
+          min_tail_(0) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("BroadcastRing capacity must be a power of two");
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    size_t add_consumer() {
+        size_t consumer = num_consumers_.load(std::memory_order_relaxed);
+        if (consumer >= max_consumers_) {
+            throw std::runtime_error("BroadcastRing consumer limit reached");
+        }
+        cursors_[consumer].next.store(head_.load(std::memory_order_relaxed),
+                                      std::memory_order_relaxed);
+        num_consumers_.store(consumer + 1, std::memory_order_release);
+        return consumer;
+    }
+
+    // Producer only; false when the slowest consumer has not freed a slot
+    bool try_publish(const T& item) {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+
+        if (head - min_tail_ >= capacity_) {
+            min_tail_ = slowest(head);
+            if (head - min_tail_ >= capacity_) {
+                return false;
+            }
+        }
+
+        slots_[head & (capacity_ - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool poll(size_t consumer, T& item) {
+        Cursor& cursor = cursors_[consumer];
+        const uint64_t next = cursor.next.load(std::memory_order_relaxed);
+
+        if (next == head_.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = slots_[next & (capacity_ - 1)];
+        cursor.next.store(next + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t published() const { return head_.load(std::memory_order_acquire); }
+    uint64_t consumed(size_t consumer) const {
+        return cursors_[consumer].next.load(std::memory_order_acquire);
+    }
+    size_t num_consumers() const { return num_consumers_.load(std::memory_order_acquire); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> next{0};
+    };
+
+    const size_t capacity_;
+    std::unique_ptr<T[]> slots_;
+    std::unique_ptr<Cursor[]> cursors_;
+    const size_t max_consumers_;
+    std::atomic<size_t> num_consumers_;
+
+    alignas(64) std::atomic<uint64_t> head_;
+    uint64_t min_tail_;     // producer's cached slowest cursor
+
+    uint64_t slowest(uint64_t head) const {
+        uint64_t tail = head;
+        size_t count = num_consumers_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            tail = std::min(tail, cursors_[i].next.load(std::memory_order_acquire));
+        }
+        return tail;
+    }
+};
+
+} // namespace utils
+} // namespace quantflow
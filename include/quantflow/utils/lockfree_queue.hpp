@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 
@@ -37,6 +38,20 @@ public:
         return true;
     }
     
+    // Pushes as many of the items as fit and publishes them with a single
+    // store; returns how many were pushed
+    size_t push(const T* items, size_t count) {
+        const size_t current_tail = tail_.load(std::memory_order_relaxed);
+        const size_t free = (head_.load(std::memory_order_acquire) - current_tail - 1) & (capacity_ - 1);
+        const size_t n = std::min(count, free);
+        
+        for (size_t i = 0; i < n; ++i) {
+            buffer_[(current_tail + i) & (capacity_ - 1)] = items[i];
+        }
+        tail_.store((current_tail + n) & (capacity_ - 1), std::memory_order_release);
+        return n;
+    }
+    
     bool pop(T& item) {
         const size_t current_head = head_.load(std::memory_order_relaxed);
         
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace quantflow {
+namespace utils {
+
+// A read-write file mapping that can grow, behind one interface for POSIX
+// (mmap/msync) and Windows (CreateFileMapping/FlushViewOfFile).
+//
+// On POSIX, max_size bytes of address space are reserved at open and the
+// file is mapped into them, so growing maps only the new tail and data()
+// never moves. Windows has no portable equivalent, so there resize()
+// remaps the whole file and data() may change; callers that flush from
+// another thread must then hold off flushes while it runs (see
+// grows_in_place).
+class MappedFile {
+public:
+#ifdef _WIN32
+    static constexpr bool grows_in_place = false;
+#else
+    static constexpr bool grows_in_place = true;
+#endif
+
+    // Mappings, flushes and truncation work in whole pages
+    static size_t page_size();
+
+    // Opens or creates the file; nothing is mapped until resize()
+    MappedFile(const std::string& path, size_t max_size);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const std::string& path() const { return path_; }
+    char* data() const { return base_; }
+    size_t mapped() const { return mapped_; }
+
+    // File size when opened, or as last set by resize/truncate
+    size_t file_size() const { return file_size_; }
+
+    // Sizes the file to `size` bytes and maps all of it. size must be a
+    // multiple of page_size() and at most max_size; throws on failure.
+    void resize(size_t size);
+
+    // Unmaps, cuts the file to `size` bytes and writes the new size
+    // through; resize() maps it again. Returns false on failure.
+    bool truncate(size_t size);
+
+    // Writes [offset, offset + length) of the mapping through to disk.
+    // Returns 0, or the platform error code; describe() turns it into text.
+    int flush(size_t offset, size_t length);
+    static std::string describe(int error);
+
+private:
+    std::string path_;
+    size_t file_size_;
+    size_t reserved_;
+    size_t mapped_;
+    char* base_;
+
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int fd_;
+#endif
+
+    void unmap();
+};
+
+} // namespace utils
+} // namespace quantflow
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace quantflow {
+namespace utils {
+
+// Position of each name in a fixed list, for the dense per-universe
+// containers keyed by symbol. The first occurrence of a repeated name wins.
+class NameIndex {
+public:
+    NameIndex() = default;
+
+    explicit NameIndex(const std::vector<std::string>& names) {
+        index_.reserve(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            index_.emplace(names[i], i);
+        }
+    }
+
+    bool find(const std::string& name, size_t& index) const {
+        auto it = index_.find(name);
+        if (it == index_.end()) return false;
+        index = it->second;
+        return true;
+    }
+
+private:
+    std::unordered_map<std::string, size_t> index_;
+};
+
+} // namespace utils
+} // namespace quantflow
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "quantflow/utils/binary_io.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace quantflow {
+namespace utils {
+
+constexpr size_t next_power_of_two(size_t n) {
+    size_t capacity = 1;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+// The last `period` values pushed, oldest first, in a ring whose capacity
+// is the next power of two so positions wrap with a mask. Storage is
+// allocated once, at construction; pushing into a full window overwrites
+// the oldest value.
+//
+// With Period > 0 the period is a compile-time constant and the ring is
+// an inline array; with Period == 0 it is given to the constructor.
+template<typename T, size_t Period = 0>
+class RingWindow {
+public:
+    explicit RingWindow(size_t period = Period)
+        : period_(period), head_(0), size_(0) {
+        if (period == 0 || (Period > 0 && period != Period)) {
+            throw std::invalid_argument("RingWindow period must be positive and match its template period");
+        }
+        if (period > (std::numeric_limits<size_t>::max() >> 1) + 1) {
+            throw std::length_error("RingWindow period too large");
+        }
+        if constexpr (Period == 0) {
+            slots_.resize(next_power_of_two(period));
+        }
+    }
+
+    size_t period() const { return Period > 0 ? Period : period_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ == period(); }
+
+    // i = 0 is the oldest value
+    const T& operator[](size_t i) const { return slots_[(head_ + i) & mask()]; }
+    const T& oldest() const { return slots_[head_]; }
+    const T& newest() const { return (*this)[size_ - 1]; }
+
+    void push(const T& value) {
+        slots_[(head_ + size_) & mask()] = value;
+        if (full()) {
+            head_ = (head_ + 1) & mask();
+        } else {
+            ++size_;
+        }
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+    // Replaces the contents with the last period() values of [first, last)
+    void assign(const T* first, const T* last) {
+        clear();
+        size_t count = static_cast<size_t>(last - first);
+        for (const T* it = first + (count > period() ? count - period() : 0); it != last; ++it) {
+            push(*it);
+        }
+    }
+
+    // Calls fn(value) oldest first, as two straight runs over the ring
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        size_t first = std::min(size_, capacity() - head_);
+        for (size_t i = 0; i < first; ++i) {
+            fn(slots_[head_ + i]);
+        }
+        for (size_t i = 0; i < size_ - first; ++i) {
+            fn(slots_[i]);
+        }
+    }
+
+    // Count, then values oldest first
+    void save_state(BinaryWriter& out) const {
+        out.write<uint64_t>(size_);
+        for_each([&](const T& value) { out.write(value); });
+    }
+
+    void load_state(BinaryReader& in) {
+        clear();
+        auto count = in.read<uint64_t>();
+        for (uint64_t i = 0; i < count; ++i) {
+            push(in.read<T>());
+        }
+    }
+
+private:
+    using Storage = std::conditional_t<Period == 0, std::vector<T>,
+                                       std::array<T, next_power_of_two(Period)>>;
+
+    Storage slots_;
+    size_t period_;
+    size_t head_;
+    size_t size_;
+
+    size_t capacity() const { return slots_.size(); }
+    size_t mask() const { return slots_.size() - 1; }
+};
+
+} // namespace utils
+} // namespace quantflow
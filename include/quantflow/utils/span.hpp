@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace quantflow {
+namespace utils {
+
+// Non-owning view of a contiguous array (std::span stand-in for C++17).
+// Span<const T> is the read-only form handed out for results.
+template<typename T>
+class Span {
+public:
+    Span() : data_(nullptr), size_(0) {}
+    Span(T* data, size_t size) : data_(data), size_(size) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    Span(std::vector<U>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible<const U*, T*>::value>>
+    Span(const std::vector<U>& vec) : data_(vec.data()), size_(vec.size()) {}
+
+    // Span<T> converts to Span<const T>
+    template<typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    Span(const Span<U>& other) : data_(other.data()), size_(other.size()) {}
+
+    T* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    T& operator[](size_t i) const { return data_[i]; }
+    T* begin() const { return data_; }
+    T* end() const { return data_ + size_; }
+
+    Span subspan(size_t offset, size_t count) const { return Span(data_ + offset, count); }
+
+private:
+    T* data_;
+    size_t size_;
+};
+
+} // namespace utils
+} // namespace quantflow
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace quantflow {
+namespace utils {
+
+// Interns strings as small integer handles. Handle 0 is the empty string.
+// Interning a string already in the pool does not allocate; stored strings
+// never move, so get() references stay valid for the pool's lifetime.
+class StringPool {
+public:
+    using Handle = uint32_t;
+
+    StringPool() {
+        strings_.emplace_back();
+    }
+
+    Handle intern(std::string_view str) {
+        if (str.empty()) return 0;
+
+        auto it = index_.find(str);
+        if (it != index_.end()) return it->second;
+
+        auto handle = static_cast<Handle>(strings_.size());
+        strings_.emplace_back(str);
+        index_.emplace(strings_.back(), handle);
+        return handle;
+    }
+
+    // Handle of an already interned string, or 0
+    Handle find(std::string_view str) const {
+        auto it = index_.find(str);
+        return (it != index_.end()) ? it->second : 0;
+    }
+
+    const std::string& get(Handle handle) const { return strings_[handle]; }
+    size_t size() const { return strings_.size(); }
+
+private:
+    std::deque<std::string> strings_;
+    std::unordered_map<std::string_view, Handle> index_;
+};
+
+} // namespace utils
+} // namespace quantflow
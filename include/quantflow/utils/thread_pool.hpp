@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace quantflow {
+namespace utils {
+
+// Fork/join pool for short, frequent parallel_for rounds. The calling
+// thread takes part in every round, so a pool of size N spawns N - 1
+// workers. parallel_for returns only after every index has run (barrier)
+// and rethrows the first exception raised by a task.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t num_threads)
+        : stopping_(false),
+          generation_(0),
+          task_size_(0),
+          next_index_(0),
+          active_workers_(0) {
+        for (size_t i = 1; i < num_threads; ++i) {
+            workers_.emplace_back(&ThreadPool::worker_loop, this);
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size() + 1; }
+
+    template<typename F>
+    void parallel_for(size_t count, F&& fn) {
+        if (count == 0) return;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = std::forward<F>(fn);
+            task_size_ = count;
+            next_index_.store(0, std::memory_order_relaxed);
+            active_workers_ = workers_.size();
+            error_ = nullptr;
+            ++generation_;
+        }
+        start_cv_.notify_all();
+
+        run_tasks();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return active_workers_ == 0; });
+
+        task_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+
+    bool stopping_;
+    uint64_t generation_;
+    std::function<void(size_t)> task_;
+    size_t task_size_;
+    std::atomic<size_t> next_index_;
+    size_t active_workers_;
+    std::exception_ptr error_;
+
+    void run_tasks() {
+        size_t index;
+        while ((index = next_index_.fetch_add(1, std::memory_order_relaxed)) < task_size_) {
+            try {
+                task_(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen_generation = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [&] {
+                    return stopping_ || generation_ != seen_generation;
+                });
+                if (stopping_) return;
+                seen_generation = generation_;
+            }
+
+            run_tasks();
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_workers_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+};
+
+} // namespace utils
+} // namespace quantflow
@@ -1,142 +1,583 @@
 #include "quantflow/backtest/backtest_engine.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace quantflow {
 namespace backtest {
 
+namespace {
+
+constexpr uint32_t CHECKPOINT_MAGIC = 0x4B434651;  // "QFCK"
+constexpr uint32_t CHECKPOINT_VERSION = 9;
+
+bool needs_price(OrderType type) {
+    return type == OrderType::LIMIT || type == OrderType::STOP_LIMIT;
+}
+
+bool needs_stop(OrderType type) {
+    return type == OrderType::STOP || type == OrderType::STOP_LIMIT;
+}
+
+void write_position(utils::BinaryWriter& out, const Position& pos) {
+    out.write_string(pos.symbol);
+    out.write(pos.quantity);
+    out.write(pos.avg_entry_price);
+    out.write(pos.current_price);
+    out.write(pos.realized_pnl);
+    out.write(pos.unrealized_pnl);
+    out.write(pos.total_pnl);
+    out.write(pos.total_commission);
+    out.write(pos.opened_at);
+    out.write(pos.last_updated);
+}
+
+void read_position(utils::BinaryReader& in, Position& pos) {
+    pos.symbol = in.read_string();
+    in.read(pos.quantity);
+    in.read(pos.avg_entry_price);
+    in.read(pos.current_price);
+    in.read(pos.realized_pnl);
+    in.read(pos.unrealized_pnl);
+    in.read(pos.total_pnl);
+    in.read(pos.total_commission);
+    in.read(pos.opened_at);
+    in.read(pos.last_updated);
+}
+
+void write_order(utils::BinaryWriter& out, const Order& order) {
+    out.write(order.id);
+    out.write_string(order.symbol);
+    out.write(order.type);
+    out.write(order.side);
+    out.write(order.quantity);
+    out.write(order.price);
+    out.write(order.stop_price);
+    out.write(order.tif);
+    out.write(order.status);
+    out.write(order.filled_quantity);
+    out.write(order.remaining_quantity);
+    out.write(order.avg_fill_price);
+    out.write(order.created_at);
+    out.write(order.submitted_at);
+    out.write(order.updated_at);
+    out.write(order.filled_at);
+    out.write_string(order.strategy_id);
+    out.write_string(order.exchange_id);
+    out.write_string(order.client_order_id);
+    out.write_string(order.exchange_order_id);
+    out.write_string(order.rejection_reason);
+}
+
+void read_order(utils::BinaryReader& in, Order& order) {
+    in.read(order.id);
+    order.symbol = in.read_string();
+    in.read(order.type);
+    in.read(order.side);
+    in.read(order.quantity);
+    in.read(order.price);
+    in.read(order.stop_price);
+    in.read(order.tif);
+    in.read(order.status);
+    in.read(order.filled_quantity);
+    in.read(order.remaining_quantity);
+    in.read(order.avg_fill_price);
+    in.read(order.created_at);
+    in.read(order.submitted_at);
+    in.read(order.updated_at);
+    in.read(order.filled_at);
+    order.strategy_id = in.read_string();
+    order.exchange_id = in.read_string();
+    order.client_order_id = in.read_string();
+    order.exchange_order_id = in.read_string();
+    order.rejection_reason = in.read_string();
+}
+
+void write_fill(utils::BinaryWriter& out, const Fill& fill) {
+    out.write(fill.id);
+    out.write(fill.order_id);
+    out.write_string(fill.symbol);
+    out.write(fill.side);
+    out.write(fill.quantity);
+    out.write(fill.price);
+    out.write(fill.commission);
+    out.write(fill.slippage);
+    out.write(fill.timestamp);
+    out.write_string(fill.exchange_id);
+}
+
+void read_fill(utils::BinaryReader& in, Fill& fill) {
+    in.read(fill.id);
+    in.read(fill.order_id);
+    fill.symbol = in.read_string();
+    in.read(fill.side);
+    in.read(fill.quantity);
+    in.read(fill.price);
+    in.read(fill.commission);
+    in.read(fill.slippage);
+    in.read(fill.timestamp);
+    fill.exchange_id = in.read_string();
+}
+
+} // namespace
+
 BacktestEngine::BacktestEngine(const BacktestConfig& config)
-    : config_(config), next_order_id_(1) {
+    : config_(config),
+      book_(&portfolio_.positions),
+      lots_(config.lot_method),
+      snapshots_(config.snapshot_interval > 0 ? config.snapshot_capacity : 0),
+      fill_sim_(execution::FillSimulatorConfig{config.slippage_bps, config.max_participation}),
+      next_order_id_(1),
+      next_fill_id_(1),
+      current_time_(0),
+      timers_(config.timer_resolution),
+      next_timer_id_(1),
+      bars_since_resync_(0),
+      analyzer_(config.initial_cash, constants::RISK_FREE_RATE,
+                std::max<size_t>(config.equity_sample_interval, 1)),
+      unrecorded_fills_(0),
+      sample_interval_(std::max<size_t>(config.equity_sample_interval, 1)),
+      bars_since_sample_(0),
+      curve_stride_(1),
+      samples_since_point_(0),
+      cursor_(0),
+      cursor_timestamp_(0),
+      started_(false) {
     portfolio_.cash = config.initial_cash;
     portfolio_.equity = config.initial_cash;
     portfolio_.buying_power = config.initial_cash;
 }
 
+BacktestEngine::~BacktestEngine() = default;
+
 void BacktestEngine::add_strategy(std::shared_ptr<strategy::Strategy> strategy) {
-    strategy->set_context(this);
+    auto block = static_cast<uint16_t>(slots_.size() + 1);
+    slots_.push_back(std::make_unique<StrategySlot>(*this, strategy, block));
+    strategy->set_context(slots_.back().get());
     strategies_.push_back(strategy);
 }
 
 void BacktestEngine::add_data(const std::vector<Bar>& bars) {
-    bars_ = bars;
-    std::sort(bars_.begin(), bars_.end(),
-        [](const Bar& a, const Bar& b) { return a.timestamp < b.timestamp; });
+    data_ = data::BarSeries::create(bars);
+}
+
+void BacktestEngine::set_data(data::BarSeriesPtr series) {
+    data_ = std::move(series);
 }
 
 void BacktestEngine::run() {
-    for (auto& strategy : strategies_) {
-        strategy->on_init();
+    if (!started_) {
+        for (auto& strategy : strategies_) {
+            strategy->on_init();
+        }
+        merge_order_actions(nullptr);
     }
     
-    for (const auto& bar : bars_) {
+    if (!data_) return;
+    
+    if (config_.strategy_threads > 1 && slots_.size() > 1 && !pool_) {
+        pool_ = std::make_unique<utils::ThreadPool>(
+            std::min(config_.strategy_threads, slots_.size()));
+    }
+    
+    if (!started_) {
+        started_ = true;
+        cursor_ = 0;
+        
+        sample_interval_ = std::max<size_t>(config_.equity_sample_interval, 1);
+        bars_since_sample_ = 0;
+        curve_stride_ = 1;
+        samples_since_point_ = 0;
+        
+        analyzer_.reset(config_.initial_cash);
+        analyzer_.add_equity(portfolio_.equity);
+        
+        equity_curve_.clear();
+        fills_.clear();
+        unrecorded_fills_ = 0;
+        
+        if (config_.record_equity_curve) {
+            equity_curve_.push_back(portfolio_.equity);
+        }
+    } else {
+        resolve_cursor();
+    }
+    
+    if (config_.record_equity_curve && cursor_ < data_->size()) {
+        size_t expected_points = equity_curve_.size() +
+            (data_->size() - cursor_) / (sample_interval_ * curve_stride_) + 1;
+        if (config_.max_equity_points > 0) {
+            expected_points = std::min(expected_points, config_.max_equity_points + 1);
+        }
+        equity_curve_.reserve(expected_points);
+    }
+    
+    // Up to a fill a bar, within the cap
+    if (config_.record_fills && cursor_ < data_->size()) {
+        size_t expected_fills = fills_.size() + (data_->size() - cursor_);
+        if (config_.max_fills > 0) {
+            expected_fills = std::min(expected_fills, config_.max_fills);
+        }
+        fills_.reserve(expected_fills);
+    }
+    
+    while (cursor_ < data_->size()) {
+        const Bar& bar = (*data_)[cursor_];
+        fire_timers(bar.timestamp);
         process_bar(bar);
+        
+        ++cursor_;
+        cursor_timestamp_ = bar.timestamp;
+        
+        if (++bars_since_sample_ >= sample_interval_) {
+            sample_equity();
+        }
+        
+        if (config_.checkpoint_interval > 0 && !config_.checkpoint_path.empty() &&
+            cursor_ % config_.checkpoint_interval == 0) {
+            save_checkpoint(config_.checkpoint_path);
+        }
+        
+        if (config_.snapshot_interval > 0 && cursor_ % config_.snapshot_interval == 0) {
+            publish_snapshot();
+        }
+    }
+    
+    // Always close the curve on the final state
+    if (bars_since_sample_ > 0) {
+        sample_equity();
+    }
+    if (samples_since_point_ > 0) {
+        append_curve_point();
+    }
+    if (config_.snapshot_interval > 0) {
+        publish_snapshot();
     }
 }
 
-void BacktestEngine::process_bar(const Bar& bar) {
-    update_portfolio(bar);
+void BacktestEngine::resolve_cursor() {
+    // The checkpointed cursor is only trusted if the series still holds the
+    // same bar there; otherwise resume after the last processed timestamp
+    if (cursor_ > 0 && cursor_ <= data_->size() &&
+        (*data_)[cursor_ - 1].timestamp == cursor_timestamp_) {
+        return;
+    }
+    cursor_ = (cursor_ > 0) ? data_->lower_bound(cursor_timestamp_ + 1) : 0;
+}
+
+void BacktestEngine::sample_equity() {
+    bars_since_sample_ = 0;
+    analyzer_.add_equity(portfolio_.equity);
     
-    for (auto& strategy : strategies_) {
-        strategy->on_bar(bar);
+    if (config_.record_equity_curve && ++samples_since_point_ >= curve_stride_) {
+        append_curve_point();
     }
+}
+
+void BacktestEngine::append_curve_point() {
+    samples_since_point_ = 0;
+    equity_curve_.push_back(portfolio_.equity);
     
-    // Execute pending orders
-    for (auto& [id, order] : orders_) {
-        if (order.is_open() && order.symbol == bar.symbol) {
-            execute_order(order, bar.close);
+    if (config_.max_equity_points > 0 &&
+        equity_curve_.size() >= config_.max_equity_points) {
+        // Keep every other point; the first and most recent survive
+        size_t kept = 0;
+        for (size_t i = 0; i < equity_curve_.size(); i += 2) {
+            equity_curve_[kept++] = equity_curve_[i];
         }
+        if ((equity_curve_.size() & 1) == 0) {
+            equity_curve_[kept++] = equity_curve_.back();
+        }
+        equity_curve_.resize(kept);
+        curve_stride_ *= 2;
     }
 }
 
-void BacktestEngine::execute_order(Order& order, double price) {
-    double fill_price = price * (1.0 + config_.slippage_bps / 10000.0);
-    double commission = order.quantity * fill_price * config_.commission_rate;
-    
-    Fill fill;
-    fill.id = next_order_id_++;
-    fill.order_id = order.id;
-    fill.symbol = order.symbol;
-    fill.side = order.side;
-    fill.quantity = order.quantity;
-    fill.price = fill_price;
-    fill.commission = commission;
-    fill.timestamp = order.created_at;
+void BacktestEngine::process_bar(const Bar& bar) {
+    current_time_ = bar.timestamp;
+    update_portfolio(bar);
     
-    order.status = OrderStatus::FILLED;
-    order.filled_quantity = order.quantity;
-    order.avg_fill_price = fill_price;
+    // Orders resting from earlier bars trade against this bar's range
+    fill_sim_.match(bar, pending_fills_);
+    apply_fills();
     
-    // Update position
-    auto& pos = portfolio_.positions[order.symbol];
-    if (order.is_buy()) {
-        pos.quantity += order.quantity;
-        pos.avg_entry_price = ((pos.avg_entry_price * (pos.quantity - order.quantity)) +
-                               (fill_price * order.quantity)) / pos.quantity;
-        portfolio_.cash -= fill.total_cost();
+    // Strategies only read engine state during on_bar, so they can run
+    // concurrently; their order actions wait in per-slot buffers
+    if (pool_) {
+        pool_->parallel_for(slots_.size(), [this, &bar](size_t i) {
+            slots_[i]->strategy->on_bar(bar);
+        });
     } else {
-        pos.quantity -= order.quantity;
-        portfolio_.cash += fill.notional() - commission;
+        for (auto& slot : slots_) {
+            slot->strategy->on_bar(bar);
+        }
     }
     
-    for (auto& strategy : strategies_) {
-        strategy->on_fill(fill);
+    // New orders get a chance at this bar's close
+    merge_order_actions(&bar);
+    apply_fills();
+    
+    // Orders placed from on_fill rest until the next bar
+    merge_order_actions(nullptr);
+}
+
+void BacktestEngine::merge_order_actions(const Bar* bar) {
+    for (auto& slot : slots_) {
+        for (auto& action : slot->actions) {
+            if (action.order.id != 0) {
+                OrderID id = action.order.id;
+                auto [it, inserted] = orders_.emplace(id, std::move(action.order));
+                if (inserted) {
+                    submit_order(it->second, bar);
+                }
+            } else {
+                cancel_order(action.cancel_id);
+            }
+        }
+        slot->actions.clear();
+        
+        for (const auto& action : slot->timer_actions) {
+            if (action.cancel) {
+                timers_.cancel(action.id);
+            } else {
+                timers_.schedule(action.id, action.when, action.user_data,
+                                 action.interval, slot->block);
+            }
+        }
+        slot->timer_actions.clear();
+    }
+}
+
+void BacktestEngine::fire_timers(Timestamp now) {
+    // Timers due up to and including the bar's timestamp run before it
+    DueTimer due;
+    while (timers_.pop_due(now, due)) {
+        current_time_ = std::max(current_time_, due.when);
+        TimerEvent event{due.id, due.when, due.user_data};
+        
+        if (due.owner == 0) {
+            for (auto& strategy : strategies_) {
+                strategy->on_timer(event);
+            }
+        } else {
+            slots_[due.owner - 1]->strategy->on_timer(event);
+        }
+        
+        // Orders placed from on_timer rest and trade against the coming bar
+        merge_order_actions(nullptr);
+    }
+}
+
+void BacktestEngine::submit_order(Order& order, const Bar* bar) {
+    add_working(order, order.remaining_quantity);
+    fill_sim_.submit(order, bar, pending_fills_);
+}
+
+void BacktestEngine::add_working(const Order& order, double quantity) {
+    portfolio::SymbolIndex pos = book_.index(order.symbol);
+    if (pos >= working_.size()) {
+        working_.resize(book_.size(), 0.0);
+    }
+    working_[pos] += order.is_buy() ? quantity : -quantity;
+}
+
+void BacktestEngine::apply_fills() {
+    for (const auto& sim_fill : pending_fills_) {
+        Order& order = *sim_fill.order;
+        double quantity = sim_fill.quantity;
+        double commission = quantity * sim_fill.price * config_.commission_rate;
+        
+        Fill fill{};
+        fill.id = next_fill_id_++;
+        fill.order_id = order.id;
+        fill.symbol = order.symbol;
+        fill.side = order.side;
+        fill.quantity = quantity;
+        fill.price = sim_fill.price;
+        fill.commission = commission;
+        fill.slippage = sim_fill.slippage;
+        fill.timestamp = current_time_;
+        
+        order.updated_at = current_time_;
+        if (order.is_filled()) {
+            order.filled_at = current_time_;
+        }
+        
+        // Update position; the lots give quantity, realized P&L and entry price
+        add_working(order, -quantity);
+        portfolio::SymbolIndex pos = book_.index(order.symbol);
+        double signed_quantity = order.is_buy() ? quantity : -quantity;
+        double realized = lots_.apply(pos, signed_quantity, fill.price, current_time_);
+        book_.add_realized_pnl(pos, realized);
+        book_.set_quantity(pos, lots_.quantity(pos), current_time_);
+        book_.set_avg_entry_price(pos, lots_.avg_entry_price(pos));
+        book_.add_commission(pos, commission);
+        if (book_.current_price(pos) == 0.0) {
+            // Not marked by a bar yet: value it at the fill until one arrives
+            book_.mark(pos, sim_fill.price, current_time_);
+        }
+        if (order.is_buy()) {
+            portfolio_.cash -= fill.total_cost();
+        } else {
+            portfolio_.cash += fill.notional() - commission;
+        }
+        book_.sync_view();
+        portfolio_.equity = portfolio_.cash + book_.market_value();
+        
+        analyzer_.add_fill(fill, realized);
+        if (config_.record_fills) {
+            if (config_.max_fills == 0 || fills_.size() < config_.max_fills) {
+                fills_.push_back(fill);
+            } else {
+                ++unrecorded_fills_;
+            }
+        }
+        
+        for (auto& strategy : strategies_) {
+            strategy->on_fill(fill);
+        }
     }
+    pending_fills_.clear();
 }
 
 void BacktestEngine::update_portfolio(const Bar& bar) {
-    auto it = portfolio_.positions.find(bar.symbol);
-    if (it != portfolio_.positions.end()) {
-        it->second.current_price = bar.close;
-        it->second.unrealized_pnl = (bar.close - it->second.avg_entry_price) * it->second.quantity;
+    // Only the bar's symbol moved, so only its value change is applied
+    portfolio::SymbolIndex pos;
+    if (book_.find(bar.symbol, pos)) {
+        book_.mark(pos, bar.close, bar.timestamp);
+        book_.sync_view();
     }
     
-    double total_value = portfolio_.cash;
-    for (const auto& [sym, pos] : portfolio_.positions) {
-        total_value += pos.market_value();
+    if (config_.equity_resync_interval > 0 &&
+        ++bars_since_resync_ >= config_.equity_resync_interval) {
+        bars_since_resync_ = 0;
+        book_.resync();
     }
-    portfolio_.equity = total_value;
+    portfolio_.equity = portfolio_.cash + book_.market_value();
 }
 
-OrderID BacktestEngine::buy(const Symbol& symbol, double quantity, double price) {
-    Order order;
-    order.id = next_order_id_++;
-    order.symbol = symbol;
-    order.type = (price > 0) ? OrderType::LIMIT : OrderType::MARKET;
-    order.side = OrderSide::BUY;
-    order.quantity = quantity;
-    order.price = price;
-    order.status = OrderStatus::SUBMITTED;
-    order.created_at = TimeUtils::now();
+void BacktestEngine::publish_snapshot() {
+    snapshots_.publish(book_, portfolio_.cash, portfolio_.equity, current_time_);
+}
+
+OrderID BacktestEngine::make_order_id(uint16_t block, uint64_t sequence) {
+    return (static_cast<OrderID>(block) << 48) | sequence;
+}
+
+strategy::OrderRequest BacktestEngine::limit_or_market(const Symbol& symbol, OrderSide side,
+                                                       double quantity, double price) {
+    return {symbol, side, quantity, (price > 0) ? OrderType::LIMIT : OrderType::MARKET, price};
+}
+
+void BacktestEngine::validate_request(const strategy::OrderRequest& request) {
+    if ((needs_price(request.type) && request.price <= 0) ||
+        (needs_stop(request.type) && request.stop_price <= 0)) {
+        throw std::invalid_argument("Order for " + request.symbol + " is missing its limit or stop price");
+    }
+}
+
+Order BacktestEngine::make_order(OrderID id, const strategy::OrderRequest& request) const {
+    validate_request(request);
     
-    orders_[order.id] = order;
-    return order.id;
+    Order order{};
+    order.id = id;
+    order.symbol = request.symbol;
+    order.type = request.type;
+    order.side = request.side;
+    order.quantity = request.quantity;
+    order.remaining_quantity = request.quantity;
+    order.price = needs_price(request.type) ? request.price : 0.0;
+    order.stop_price = needs_stop(request.type) ? request.stop_price : 0.0;
+    order.status = OrderStatus::SUBMITTED;
+    order.created_at = current_time_;
+    return order;
+}
+
+OrderID BacktestEngine::buy(const Symbol& symbol, double quantity, double price) {
+    return submit_order(limit_or_market(symbol, OrderSide::BUY, quantity, price));
 }
 
 OrderID BacktestEngine::sell(const Symbol& symbol, double quantity, double price) {
-    Order order;
-    order.id = next_order_id_++;
-    order.symbol = symbol;
-    order.type = (price > 0) ? OrderType::LIMIT : OrderType::MARKET;
-    order.side = OrderSide::SELL;
-    order.quantity = quantity;
-    order.price = price;
-    order.status = OrderStatus::SUBMITTED;
-    order.created_at = TimeUtils::now();
-    
-    orders_[order.id] = order;
-    return order.id;
+    return submit_order(limit_or_market(symbol, OrderSide::SELL, quantity, price));
+}
+
+OrderID BacktestEngine::submit_order(const strategy::OrderRequest& request) {
+    OrderID id = make_order_id(0, next_order_id_);
+    Order& order = orders_[id] = make_order(id, request);
+    ++next_order_id_;
+    submit_order(order, nullptr);
+    return id;
 }
 
 void BacktestEngine::cancel_order(OrderID order_id) {
     auto it = orders_.find(order_id);
-    if (it != orders_.end()) {
+    if (it != orders_.end() && it->second.is_open()) {
+        add_working(it->second, -it->second.remaining_quantity);
         it->second.status = OrderStatus::CANCELLED;
+        it->second.updated_at = current_time_;
+    }
+}
+
+std::vector<OrderID> BacktestEngine::submit_orders(
+    const std::vector<strategy::OrderRequest>& requests) {
+    // The whole batch is checked before any of it is placed
+    for (const auto& request : requests) {
+        validate_request(request);
+    }
+    
+    std::vector<OrderID> ids(requests.size());
+    uint64_t first = next_order_id_;
+    next_order_id_ += requests.size();
+    
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        OrderID id = ids[i] = make_order_id(0, first + i);
+        Order& order = orders_[id] = make_order(id, request);
+        submit_order(order, nullptr);
+    }
+    return ids;
+}
+
+void BacktestEngine::cancel_orders(const std::vector<OrderID>& order_ids) {
+    for (OrderID order_id : order_ids) {
+        cancel_order(order_id);
     }
 }
 
+std::vector<OrderID> BacktestEngine::rebalance(strategy::RebalanceUniverse& universe,
+                                               const std::vector<double>& weights) {
+    std::vector<strategy::OrderRequest> orders;
+    plan_rebalance(universe, weights, orders);
+    return submit_orders(orders);
+}
+
+void BacktestEngine::plan_rebalance(strategy::RebalanceUniverse& universe,
+                                    const std::vector<double>& weights,
+                                    std::vector<strategy::OrderRequest>& orders) const {
+    if (weights.size() != universe.size()) {
+        throw std::invalid_argument("rebalance needs one weight per universe symbol");
+    }
+    universe.load_holdings(book_, working_.data());
+    universe.plan(weights.data(), portfolio_.equity, orders);
+}
+
+TimerID BacktestEngine::schedule_timer(Timestamp when, uint64_t user_data, Duration interval) {
+    TimerID id = make_order_id(0, next_timer_id_++);
+    timers_.schedule(id, when, user_data, interval, 0);
+    return id;
+}
+
+void BacktestEngine::cancel_timer(TimerID timer_id) {
+    timers_.cancel(timer_id);
+}
+
 const Position* BacktestEngine::get_position(const Symbol& symbol) const {
-    auto it = portfolio_.positions.find(symbol);
-    return (it != portfolio_.positions.end()) ? &it->second : nullptr;
+    portfolio::SymbolIndex pos;
+    return book_.find(symbol, pos) ? &book_.view(pos) : nullptr;
 }
 
 const PortfolioState& BacktestEngine::get_portfolio() const {
@@ -147,17 +588,280 @@ double BacktestEngine::get_cash() const {
     return portfolio_.cash;
 }
 
+void BacktestEngine::save_checkpoint(std::ostream& stream) const {
+    utils::BinaryWriter out(stream);
+    
+    out.write(CHECKPOINT_MAGIC);
+    out.write(CHECKPOINT_VERSION);
+    
+    out.write(next_order_id_);
+    out.write(next_fill_id_);
+    out.write(current_time_);
+    out.write<uint64_t>(cursor_);
+    out.write(cursor_timestamp_);
+    out.write<uint64_t>(sample_interval_);
+    out.write<uint64_t>(bars_since_sample_);
+    out.write<uint64_t>(curve_stride_);
+    out.write<uint64_t>(samples_since_point_);
+    out.write(next_timer_id_);
+    out.write(book_.market_value());
+    out.write<uint64_t>(bars_since_resync_);
+    
+    out.write(portfolio_.cash);
+    out.write(portfolio_.equity);
+    out.write(portfolio_.margin_used);
+    out.write(portfolio_.margin_available);
+    out.write(portfolio_.buying_power);
+    out.write(portfolio_.last_updated);
+    out.write<uint64_t>(book_.size());
+    for (portfolio::SymbolIndex i = 0; i < book_.size(); ++i) {
+        write_position(out, book_.position(i));
+    }
+    lots_.save_state(out);
+    
+    uint64_t num_open = std::count_if(orders_.begin(), orders_.end(),
+        [](const auto& p) { return p.second.is_open(); });
+    out.write(num_open);
+    for (const auto& [id, order] : orders_) {
+        if (order.is_open()) {
+            write_order(out, order);
+        }
+    }
+    fill_sim_.save_state(out);
+    
+    analyzer_.save_state(out);
+    out.write_vector(equity_curve_);
+    out.write<uint64_t>(fills_.size());
+    for (const auto& fill : fills_) {
+        write_fill(out, fill);
+    }
+    out.write(unrecorded_fills_);
+    timers_.save_state(out);
+    
+    // Strategy state is length-prefixed so strategies without hooks cost
+    // eight bytes and a mismatched reader cannot overrun its neighbour
+    out.write<uint64_t>(slots_.size());
+    for (const auto& slot : slots_) {
+        out.write(slot->next_sequence);
+        out.write(slot->next_timer_sequence);
+        std::ostringstream blob;
+        utils::BinaryWriter blob_out(blob);
+        slot->strategy->save_state(blob_out);
+        out.write_string(blob.str());
+    }
+    
+    if (!out.good()) {
+        throw std::runtime_error("Failed to write backtest checkpoint");
+    }
+}
+
+void BacktestEngine::load_checkpoint(std::istream& stream) {
+    utils::BinaryReader in(stream);
+    
+    if (in.read<uint32_t>() != CHECKPOINT_MAGIC) {
+        throw std::runtime_error("Not a backtest checkpoint");
+    }
+    if (in.read<uint32_t>() != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported backtest checkpoint version");
+    }
+    
+    in.read(next_order_id_);
+    in.read(next_fill_id_);
+    in.read(current_time_);
+    cursor_ = in.read<uint64_t>();
+    in.read(cursor_timestamp_);
+    sample_interval_ = in.read<uint64_t>();
+    bars_since_sample_ = in.read<uint64_t>();
+    curve_stride_ = in.read<uint64_t>();
+    samples_since_point_ = in.read<uint64_t>();
+    in.read(next_timer_id_);
+    double market_value = in.read<double>();
+    bars_since_resync_ = in.read<uint64_t>();
+    
+    in.read(portfolio_.cash);
+    in.read(portfolio_.equity);
+    in.read(portfolio_.margin_used);
+    in.read(portfolio_.margin_available);
+    in.read(portfolio_.buying_power);
+    in.read(portfolio_.last_updated);
+    book_.clear();
+    uint64_t num_positions = in.read<uint64_t>();
+    for (uint64_t i = 0; i < num_positions; ++i) {
+        Position pos{};
+        read_position(in, pos);
+        book_.restore(pos);
+    }
+    lots_.load_state(in);
+    book_.set_market_value(market_value);
+    book_.sync_view();
+    
+    orders_.clear();
+    working_.assign(book_.size(), 0.0);
+    fill_sim_.clear();
+    uint64_t num_orders = in.read<uint64_t>();
+    std::unordered_map<OrderID, Order*> open_orders;
+    for (uint64_t i = 0; i < num_orders; ++i) {
+        Order order{};
+        read_order(in, order);
+        open_orders[order.id] = &(orders_[order.id] = order);
+        add_working(order, order.remaining_quantity);
+    }
+    // Requeued as they stood, not in id order, so fill priority carries over
+    fill_sim_.load_state(in, open_orders);
+    
+    analyzer_.load_state(in);
+    in.read_vector(equity_curve_);
+    fills_.clear();
+    uint64_t num_fills = in.read<uint64_t>();
+    fills_.reserve(num_fills);
+    for (uint64_t i = 0; i < num_fills; ++i) {
+        Fill fill{};
+        read_fill(in, fill);
+        fills_.push_back(fill);
+    }
+    in.read(unrecorded_fills_);
+    timers_.load_state(in);
+    
+    if (in.read<uint64_t>() != slots_.size()) {
+        throw std::runtime_error("Checkpoint strategy count does not match engine");
+    }
+    for (auto& slot : slots_) {
+        in.read(slot->next_sequence);
+        in.read(slot->next_timer_sequence);
+        std::istringstream blob(in.read_string());
+        utils::BinaryReader blob_in(blob);
+        slot->strategy->load_state(blob_in);
+    }
+    
+    started_ = true;
+}
+
+void BacktestEngine::save_checkpoint(const std::string& path) const {
+    // Write-then-rename so a crash never leaves a torn checkpoint behind
+    std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open checkpoint file: " + tmp_path);
+        }
+        save_checkpoint(file);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("Failed to move checkpoint into place: " + path);
+    }
+}
+
+void BacktestEngine::load_checkpoint(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open checkpoint file: " + path);
+    }
+    load_checkpoint(file);
+}
+
+PerformanceMetrics BacktestEngine::get_metrics() const {
+    return analyzer_.metrics();
+}
+
+BacktestEngine::StrategySlot::StrategySlot(
+    BacktestEngine& engine,
+    std::shared_ptr<strategy::Strategy> strategy,
+    uint16_t block)
+    : engine(engine),
+      strategy(std::move(strategy)),
+      block(block),
+      next_sequence(1),
+      next_timer_sequence(1) {}
+
+OrderID BacktestEngine::StrategySlot::buy(const Symbol& symbol, double quantity, double price) {
+    return submit_order(limit_or_market(symbol, OrderSide::BUY, quantity, price));
+}
+
+OrderID BacktestEngine::StrategySlot::sell(const Symbol& symbol, double quantity, double price) {
+    return submit_order(limit_or_market(symbol, OrderSide::SELL, quantity, price));
+}
+
+OrderID BacktestEngine::StrategySlot::submit_order(const strategy::OrderRequest& request) {
+    OrderID id = make_order_id(block, next_sequence);
+    actions.push_back({engine.make_order(id, request), 0});
+    ++next_sequence;
+    return id;
+}
+
+void BacktestEngine::StrategySlot::cancel_order(OrderID order_id) {
+    actions.push_back({Order{}, order_id});
+}
+
+std::vector<OrderID> BacktestEngine::StrategySlot::submit_orders(
+    const std::vector<strategy::OrderRequest>& requests) {
+    // The whole batch is checked before any of it is placed
+    for (const auto& request : requests) {
+        validate_request(request);
+    }
+    
+    std::vector<OrderID> ids(requests.size());
+    uint64_t first = next_sequence;
+    next_sequence += requests.size();
+    
+    actions.reserve(actions.size() + requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& request = requests[i];
+        OrderID id = ids[i] = make_order_id(block, first + i);
+        actions.push_back({engine.make_order(id, request), 0});
+    }
+    return ids;
+}
+
+void BacktestEngine::StrategySlot::cancel_orders(const std::vector<OrderID>& order_ids) {
+    actions.reserve(actions.size() + order_ids.size());
+    for (OrderID order_id : order_ids) {
+        actions.push_back({Order{}, order_id});
+    }
+}
+
+std::vector<OrderID> BacktestEngine::StrategySlot::rebalance(
+    strategy::RebalanceUniverse& universe, const std::vector<double>& weights) {
+    std::vector<strategy::OrderRequest> orders;
+    engine.plan_rebalance(universe, weights, orders);
+    return submit_orders(orders);
+}
+
+TimerID BacktestEngine::StrategySlot::schedule_timer(Timestamp when, uint64_t user_data,
+                                                     Duration interval) {
+    TimerID id = make_order_id(block, next_timer_sequence++);
+    timer_actions.push_back({id, when, user_data, interval, false});
+    return id;
+}
+
+void BacktestEngine::StrategySlot::cancel_timer(TimerID timer_id) {
+    timer_actions.push_back({timer_id, 0, 0, 0, true});
+}
+
+const Position* BacktestEngine::StrategySlot::get_position(const Symbol& symbol) const {
+    return engine.get_position(symbol);
+}
+
+const PortfolioState& BacktestEngine::StrategySlot::get_portfolio() const {
+    return engine.get_portfolio();
+}
+
+double BacktestEngine::StrategySlot::get_cash() const {
+    return engine.get_cash();
+}
+
 BacktestResult BacktestEngine::get_results() const {
+    PerformanceMetrics metrics = get_metrics();
+    
     BacktestResult result;
     result.final_equity = portfolio_.equity;
     result.total_return = ((portfolio_.equity - config_.initial_cash) / config_.initial_cash) * 100.0;
-    result.total_trades = orders_.size();
-    result.sharpe_ratio = 0.0;
-    result.max_drawdown = 0.0;
-    result.winning_trades = 0;
-    result.losing_trades = 0;
-    result.win_rate = 0.0;
-    result.profit_factor = 0.0;
+    result.total_trades = metrics.total_trades;
+    result.sharpe_ratio = metrics.sharpe_ratio;
+    result.max_drawdown = metrics.max_drawdown;
+    result.winning_trades = metrics.winning_trades;
+    result.losing_trades = metrics.losing_trades;
+    result.win_rate = metrics.win_rate;
+    result.profit_factor = metrics.profit_factor;
     return result;
 }
 
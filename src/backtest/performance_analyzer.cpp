@@ -1,109 +1,229 @@
 #include "quantflow/backtest/performance_analyzer.hpp"
-#include <numeric>
 #include <algorithm>
+#include <unordered_map>
 
 namespace quantflow {
 namespace backtest {
 
-PerformanceMetrics PerformanceAnalyzer::calculate(
-    const std::vector<double>& equity_curve,
-    const std::vector<Fill>& fills,
+StreamingPerformanceAnalyzer::StreamingPerformanceAnalyzer(
     double initial_capital,
-    double risk_free_rate) {
+    double risk_free_rate,
+    size_t sample_interval)
+    : risk_free_rate_(risk_free_rate),
+      sample_interval_(std::max<size_t>(sample_interval, 1)) {
+    reset(initial_capital);
+}
+
+void StreamingPerformanceAnalyzer::reset(double initial_capital) {
+    initial_capital_ = initial_capital;
+    
+    num_equity_ = 0;
+    last_equity_ = initial_capital;
+    num_returns_ = 0;
+    mean_return_ = 0.0;
+    m2_return_ = 0.0;
+    downside_sq_sum_ = 0.0;
+    
+    peak_equity_ = 0.0;
+    peak_index_ = 0;
+    max_drawdown_ = 0.0;
+    max_drawdown_duration_ = 0;
+    
+    total_fills_ = 0;
+    winning_trades_ = 0;
+    losing_trades_ = 0;
+    total_wins_ = 0.0;
+    total_losses_ = 0.0;
+    total_commission_ = 0.0;
+    total_slippage_ = 0.0;
+}
+
+void StreamingPerformanceAnalyzer::add_equity(double equity) {
+    if (num_equity_ == 0) {
+        peak_equity_ = equity;
+    } else {
+        double ret = (equity - last_equity_) / last_equity_;
+        
+        ++num_returns_;
+        double delta = ret - mean_return_;
+        mean_return_ += delta / num_returns_;
+        m2_return_ += delta * (ret - mean_return_);
+        
+        double excess = ret - risk_free_rate_ / periods_per_year();
+        if (excess < 0) {
+            downside_sq_sum_ += excess * excess;
+        }
+    }
     
-    PerformanceMetrics metrics{};
+    if (equity > peak_equity_) {
+        peak_equity_ = equity;
+        peak_index_ = num_equity_;
+    }
     
-    if (equity_curve.empty()) {
-        return metrics;
+    double dd = (peak_equity_ - equity) / peak_equity_;
+    max_drawdown_ = std::max(max_drawdown_, dd);
+    
+    if (equity < peak_equity_) {
+        max_drawdown_duration_ = std::max(max_drawdown_duration_, num_equity_ - peak_index_);
     }
     
-    double final_equity = equity_curve.back();
-    metrics.total_return = ((final_equity - initial_capital) / initial_capital) * 100.0;
+    last_equity_ = equity;
+    ++num_equity_;
+}
+
+void StreamingPerformanceAnalyzer::add_fill(const Fill& fill, double realized_pnl) {
+    ++total_fills_;
+    total_commission_ += fill.commission;
+    total_slippage_ += fill.slippage;
+    
+    if (realized_pnl > 0) {
+        winning_trades_++;
+        total_wins_ += realized_pnl;
+    } else if (realized_pnl < 0) {
+        losing_trades_++;
+        total_losses_ += std::abs(realized_pnl);
+    }
+}
+
+PerformanceMetrics StreamingPerformanceAnalyzer::metrics() const {
+    PerformanceMetrics metrics{};
     
-    std::vector<double> returns;
-    for (size_t i = 1; i < equity_curve.size(); ++i) {
-        double ret = (equity_curve[i] - equity_curve[i-1]) / equity_curve[i-1];
-        returns.push_back(ret);
+    if (num_equity_ == 0) {
+        return metrics;
     }
     
-    metrics.sharpe_ratio = calculate_sharpe_ratio(returns, risk_free_rate);
-    metrics.max_drawdown = calculate_max_drawdown(equity_curve);
+    const double periods = periods_per_year();
     
-    metrics.total_trades = fills.size();
+    metrics.total_return = ((last_equity_ - initial_capital_) / initial_capital_) * 100.0;
     
-    double total_pnl = 0.0;
-    double total_wins = 0.0;
-    double total_losses = 0.0;
+    if (num_returns_ > 0 && last_equity_ > 0 && initial_capital_ > 0) {
+        metrics.annualized_return =
+            (std::pow(last_equity_ / initial_capital_, periods / num_returns_) - 1.0) * 100.0;
+    }
     
-    for (const auto& fill : fills) {
-        double pnl = fill.notional();
-        total_pnl += pnl;
+    if (num_returns_ > 0) {
+        double period_rf = risk_free_rate_ / periods;
+        double std_dev = std::sqrt(m2_return_ / num_returns_);
+        double downside_dev = std::sqrt(downside_sq_sum_ / num_returns_);
         
-        if (pnl > 0) {
-            metrics.winning_trades++;
-            total_wins += pnl;
-        } else if (pnl < 0) {
-            metrics.losing_trades++;
-            total_losses += std::abs(pnl);
+        if (std_dev >= 1e-9) {
+            metrics.sharpe_ratio = ((mean_return_ - period_rf) / std_dev) * std::sqrt(periods);
+        }
+        if (downside_dev >= 1e-9) {
+            metrics.sortino_ratio = ((mean_return_ - period_rf) / downside_dev) * std::sqrt(periods);
         }
-        
-        metrics.total_commission += fill.commission;
-        metrics.total_slippage += fill.slippage;
     }
     
-    metrics.win_rate = (metrics.total_trades > 0) ?
-        (static_cast<double>(metrics.winning_trades) / metrics.total_trades) * 100.0 : 0.0;
+    metrics.max_drawdown = max_drawdown_ * 100.0;
+    metrics.max_drawdown_duration = static_cast<double>(max_drawdown_duration_);
     
-    metrics.avg_win = (metrics.winning_trades > 0) ?
-        total_wins / metrics.winning_trades : 0.0;
+    metrics.total_trades = total_fills_;
+    metrics.winning_trades = winning_trades_;
+    metrics.losing_trades = losing_trades_;
     
-    metrics.avg_loss = (metrics.losing_trades > 0) ?
-        total_losses / metrics.losing_trades : 0.0;
+    int closed_trades = winning_trades_ + losing_trades_;
     
-    metrics.profit_factor = (total_losses > 0) ?
-        total_wins / total_losses : 0.0;
+    metrics.win_rate = (closed_trades > 0) ?
+        (static_cast<double>(winning_trades_) / closed_trades) * 100.0 : 0.0;
     
-    return metrics;
-}
-
-double PerformanceAnalyzer::calculate_sharpe_ratio(
-    const std::vector<double>& returns,
-    double risk_free_rate) {
+    metrics.avg_win = (winning_trades_ > 0) ?
+        total_wins_ / winning_trades_ : 0.0;
     
-    if (returns.empty()) return 0.0;
+    metrics.avg_loss = (losing_trades_ > 0) ?
+        total_losses_ / losing_trades_ : 0.0;
     
-    double mean = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
+    metrics.profit_factor = (total_losses_ > 0) ?
+        total_wins_ / total_losses_ : 0.0;
     
-    double sq_sum = 0.0;
-    for (double ret : returns) {
-        sq_sum += (ret - mean) * (ret - mean);
-    }
-    double std_dev = std::sqrt(sq_sum / returns.size());
+    metrics.expectancy = (closed_trades > 0) ?
+        (total_wins_ - total_losses_) / closed_trades : 0.0;
     
-    if (std_dev < 1e-9) return 0.0;
+    metrics.total_commission = total_commission_;
+    metrics.total_slippage = total_slippage_;
     
-    double daily_rf = risk_free_rate / 252.0;
-    return ((mean - daily_rf) / std_dev) * std::sqrt(252.0);
+    return metrics;
+}
+
+void StreamingPerformanceAnalyzer::save_state(utils::BinaryWriter& out) const {
+    out.write(initial_capital_);
+    out.write(risk_free_rate_);
+    out.write<uint64_t>(sample_interval_);
+    
+    out.write<uint64_t>(num_equity_);
+    out.write(last_equity_);
+    out.write<uint64_t>(num_returns_);
+    out.write(mean_return_);
+    out.write(m2_return_);
+    out.write(downside_sq_sum_);
+    
+    out.write(peak_equity_);
+    out.write<uint64_t>(peak_index_);
+    out.write(max_drawdown_);
+    out.write<uint64_t>(max_drawdown_duration_);
+    
+    out.write(total_fills_);
+    out.write(winning_trades_);
+    out.write(losing_trades_);
+    out.write(total_wins_);
+    out.write(total_losses_);
+    out.write(total_commission_);
+    out.write(total_slippage_);
+}
+
+void StreamingPerformanceAnalyzer::load_state(utils::BinaryReader& in) {
+    in.read(initial_capital_);
+    in.read(risk_free_rate_);
+    sample_interval_ = std::max<size_t>(in.read<uint64_t>(), 1);
+    
+    num_equity_ = in.read<uint64_t>();
+    in.read(last_equity_);
+    num_returns_ = in.read<uint64_t>();
+    in.read(mean_return_);
+    in.read(m2_return_);
+    in.read(downside_sq_sum_);
+    
+    in.read(peak_equity_);
+    peak_index_ = in.read<uint64_t>();
+    in.read(max_drawdown_);
+    max_drawdown_duration_ = in.read<uint64_t>();
+    
+    in.read(total_fills_);
+    in.read(winning_trades_);
+    in.read(losing_trades_);
+    in.read(total_wins_);
+    in.read(total_losses_);
+    in.read(total_commission_);
+    in.read(total_slippage_);
 }
 
-double PerformanceAnalyzer::calculate_max_drawdown(
-    const std::vector<double>& equity_curve) {
+PerformanceMetrics PerformanceAnalyzer::calculate(
+    const std::vector<double>& equity_curve,
+    const std::vector<Fill>& fills,
+    double initial_capital,
+    double risk_free_rate,
+    portfolio::LotMethod lot_method,
+    size_t sample_interval) {
     
-    if (equity_curve.empty()) return 0.0;
+    if (equity_curve.empty()) {
+        return PerformanceMetrics{};
+    }
     
-    double max_dd = 0.0;
-    double peak = equity_curve[0];
+    StreamingPerformanceAnalyzer analyzer(initial_capital, risk_free_rate, sample_interval);
     
     for (double equity : equity_curve) {
-        if (equity > peak) {
-            peak = equity;
-        }
-        
-        double dd = (peak - equity) / peak;
-        max_dd = std::max(max_dd, dd);
+        analyzer.add_equity(equity);
+    }
+    
+    portfolio::LotLedger lots(lot_method);
+    std::unordered_map<Symbol, portfolio::SymbolIndex> symbols;
+    for (const auto& fill : fills) {
+        auto it = symbols.emplace(fill.symbol, static_cast<portfolio::SymbolIndex>(symbols.size())).first;
+        bool buy = fill.side == OrderSide::BUY || fill.side == OrderSide::COVER;
+        double signed_quantity = buy ? fill.quantity : -fill.quantity;
+        analyzer.add_fill(fill, lots.apply(it->second, signed_quantity, fill.price, fill.timestamp));
     }
     
-    return max_dd * 100.0;
+    return analyzer.metrics();
 }
 
 } // namespace backtest
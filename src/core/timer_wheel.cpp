@@ -0,0 +1,332 @@
+#include "quantflow/core/timer_wheel.hpp"
+#include "quantflow/utils/bits.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace quantflow {
+
+TimerWheel::TimerWheel(Timestamp resolution)
+    : resolution_(resolution) {
+    if (resolution <= 0) {
+        throw std::invalid_argument("Timer resolution must be positive");
+    }
+    clear();
+}
+
+void TimerWheel::clear() {
+    now_tick_ = 0;
+    next_sequence_ = 1;
+    nodes_.clear();
+    free_head_ = NIL;
+    index_.clear();
+    ready_.clear();
+    listed_ = 0;
+    overflow_size_ = 0;
+
+    for (auto& level : heads_) {
+        std::fill(std::begin(level), std::end(level), NIL);
+    }
+    for (auto& level : occupied_) {
+        std::fill(std::begin(level), std::end(level), 0);
+    }
+}
+
+bool TimerWheel::schedule(TimerID id, Timestamp when, uint64_t user_data,
+                          Duration interval, uint32_t owner) {
+    if (id == 0 || index_.count(id) != 0) return false;
+
+    uint32_t n = allocate();
+    Node& node = nodes_[n];
+    node.id = id;
+    node.when = when;
+    node.interval = std::max<Duration>(interval, 0);
+    node.user_data = user_data;
+    node.sequence = next_sequence_++;
+    node.tick = to_tick(when);
+    node.owner = owner;
+
+    index_.emplace(id, n);
+    place(n);
+    return true;
+}
+
+bool TimerWheel::cancel(TimerID id) {
+    auto it = index_.find(id);
+    if (it == index_.end()) return false;
+
+    uint32_t n = it->second;
+    index_.erase(it);
+
+    if (nodes_[n].state == State::LISTED) {
+        unlink(n);
+        release(n);
+    } else {
+        // Still referenced by the ready heap; freed when it surfaces
+        nodes_[n].state = State::CANCELLED;
+    }
+    return true;
+}
+
+bool TimerWheel::pop_due(Timestamp now, DueTimer& out) {
+    uint64_t target = to_tick(now);
+
+    while (true) {
+        while (!ready_.empty() && nodes_[ready_.front()].state == State::CANCELLED) {
+            release(pop_ready());
+        }
+
+        if (!ready_.empty()) {
+            // Everything still in the wheel is due after the ready heap
+            if (nodes_[ready_.front()].when > now) return false;
+
+            uint32_t n = pop_ready();
+            Node& node = nodes_[n];
+            out = {node.id, node.when, node.user_data, node.owner};
+
+            if (node.interval > 0) {
+                node.when += node.interval;
+                node.tick = to_tick(node.when);
+                node.sequence = next_sequence_++;
+                place(n);
+            } else {
+                index_.erase(node.id);
+                release(n);
+            }
+            return true;
+        }
+
+        if (now_tick_ >= target || !step(target)) return false;
+    }
+}
+
+bool TimerWheel::step(uint64_t target) {
+    if (listed_ == 0) {
+        now_tick_ = target;
+        return false;
+    }
+
+    constexpr uint64_t EPOCH_BITS = LEVELS * SLOT_BITS;
+
+    if (listed_ == overflow_size_) {
+        // Only far timers: jump straight to target's epoch. Any passed on
+        // the way land in the ready heap, which keeps them in order.
+        if ((target >> EPOCH_BITS) == (now_tick_ >> EPOCH_BITS)) {
+            now_tick_ = target;
+            return false;
+        }
+        now_tick_ = (target >> EPOCH_BITS) << EPOCH_BITS;
+        redistribute(OVERFLOW_LIST, 0);
+        return true;
+    }
+
+    // Earliest tick at which some occupied slot becomes current
+    uint64_t next = UINT64_MAX;
+    for (int level = 0; level < LEVELS; ++level) {
+        int shift = level * SLOT_BITS;
+        int current = static_cast<int>((now_tick_ >> shift) & (SLOTS - 1));
+        int slot = next_occupied(level, current);
+        if (slot >= 0) {
+            uint64_t base = (now_tick_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+            next = std::min(next, base | (static_cast<uint64_t>(slot) << shift));
+        }
+    }
+    if (overflow_size_ > 0) {
+        next = std::min(next, ((now_tick_ >> EPOCH_BITS) + 1) << EPOCH_BITS);
+    }
+
+    if (next > target) {
+        now_tick_ = target;
+        return false;
+    }
+
+    now_tick_ = next;
+
+    // Cascade from the top so timers fall through every level they skip
+    if (overflow_size_ > 0 && (now_tick_ & ((uint64_t{1} << EPOCH_BITS) - 1)) == 0) {
+        redistribute(OVERFLOW_LIST, 0);
+    }
+    for (int level = LEVELS - 1; level >= 0; --level) {
+        int shift = level * SLOT_BITS;
+        if ((now_tick_ & ((uint64_t{1} << shift) - 1)) == 0) {
+            redistribute(level, static_cast<int>((now_tick_ >> shift) & (SLOTS - 1)));
+        }
+    }
+    return true;
+}
+
+void TimerWheel::redistribute(int level, int slot) {
+    uint32_t n = heads_[level][slot];
+    if (n == NIL) return;
+
+    heads_[level][slot] = NIL;
+    if (level < LEVELS) {
+        occupied_[level][slot >> 6] &= ~(uint64_t{1} << (slot & 63));
+    }
+
+    while (n != NIL) {
+        uint32_t next = nodes_[n].next;
+        --listed_;
+        if (level == OVERFLOW_LIST) --overflow_size_;
+        place(n);
+        n = next;
+    }
+}
+
+int TimerWheel::next_occupied(int level, int after) const {
+    int from = after + 1;
+    if (from >= SLOTS) return -1;
+
+    int word = from >> 6;
+    uint64_t mask = occupied_[level][word] & (~uint64_t{0} << (from & 63));
+    while (mask == 0) {
+        if (++word >= SLOTS / 64) return -1;
+        mask = occupied_[level][word];
+    }
+    return (word << 6) + utils::lowest_bit(mask);
+}
+
+void TimerWheel::place(uint32_t n) {
+    uint64_t tick = nodes_[n].tick;
+    if (tick <= now_tick_) {
+        push_ready(n);
+        return;
+    }
+
+    // The highest differing byte picks the level
+    uint64_t diff = tick ^ now_tick_;
+    int level = utils::highest_bit(diff) / SLOT_BITS;
+    if (level >= LEVELS) {
+        link(n, OVERFLOW_LIST, 0);
+    } else {
+        link(n, level, static_cast<int>((tick >> (level * SLOT_BITS)) & (SLOTS - 1)));
+    }
+}
+
+void TimerWheel::link(uint32_t n, int level, int slot) {
+    Node& node = nodes_[n];
+    node.prev = NIL;
+    node.next = heads_[level][slot];
+    node.level = static_cast<uint8_t>(level);
+    node.slot = static_cast<uint8_t>(slot);
+    node.state = State::LISTED;
+
+    if (node.next != NIL) {
+        nodes_[node.next].prev = n;
+    }
+    heads_[level][slot] = n;
+
+    if (level < LEVELS) {
+        occupied_[level][slot >> 6] |= uint64_t{1} << (slot & 63);
+    } else {
+        ++overflow_size_;
+    }
+    ++listed_;
+}
+
+void TimerWheel::unlink(uint32_t n) {
+    Node& node = nodes_[n];
+
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.level][node.slot] = node.next;
+        if (node.next == NIL && node.level < LEVELS) {
+            occupied_[node.level][node.slot >> 6] &= ~(uint64_t{1} << (node.slot & 63));
+        }
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+
+    if (node.level == OVERFLOW_LIST) --overflow_size_;
+    --listed_;
+}
+
+void TimerWheel::push_ready(uint32_t n) {
+    nodes_[n].state = State::READY;
+    ready_.push_back(n);
+    std::push_heap(ready_.begin(), ready_.end(),
+                   [this](uint32_t a, uint32_t b) { return fires_after(a, b); });
+}
+
+uint32_t TimerWheel::pop_ready() {
+    std::pop_heap(ready_.begin(), ready_.end(),
+                  [this](uint32_t a, uint32_t b) { return fires_after(a, b); });
+    uint32_t n = ready_.back();
+    ready_.pop_back();
+    return n;
+}
+
+bool TimerWheel::fires_after(uint32_t a, uint32_t b) const {
+    const Node& x = nodes_[a];
+    const Node& y = nodes_[b];
+    return x.when != y.when ? x.when > y.when : x.sequence > y.sequence;
+}
+
+uint64_t TimerWheel::to_tick(Timestamp when) const {
+    return (when > 0) ? static_cast<uint64_t>(when / resolution_) : 0;
+}
+
+uint32_t TimerWheel::allocate() {
+    if (free_head_ != NIL) {
+        uint32_t n = free_head_;
+        free_head_ = nodes_[n].next;
+        return n;
+    }
+    nodes_.push_back(Node{});
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::release(uint32_t n) {
+    nodes_[n].state = State::FREE;
+    nodes_[n].next = free_head_;
+    free_head_ = n;
+}
+
+void TimerWheel::save_state(utils::BinaryWriter& out) const {
+    std::vector<uint32_t> pending;
+    pending.reserve(index_.size());
+    for (const auto& [id, n] : index_) {
+        pending.push_back(n);
+    }
+    std::sort(pending.begin(), pending.end(), [this](uint32_t a, uint32_t b) {
+        return nodes_[a].sequence < nodes_[b].sequence;
+    });
+
+    out.write(now_tick_);
+    out.write(next_sequence_);
+    out.write<uint64_t>(pending.size());
+    for (uint32_t n : pending) {
+        const Node& node = nodes_[n];
+        out.write(node.id);
+        out.write(node.when);
+        out.write(node.interval);
+        out.write(node.user_data);
+        out.write(node.sequence);
+        out.write(node.owner);
+    }
+}
+
+void TimerWheel::load_state(utils::BinaryReader& in) {
+    clear();
+
+    in.read(now_tick_);
+    in.read(next_sequence_);
+    uint64_t count = in.read<uint64_t>();
+    for (uint64_t i = 0; i < count; ++i) {
+        uint32_t n = allocate();
+        Node& node = nodes_[n];
+        in.read(node.id);
+        in.read(node.when);
+        in.read(node.interval);
+        in.read(node.user_data);
+        in.read(node.sequence);
+        in.read(node.owner);
+        node.tick = to_tick(node.when);
+
+        index_.emplace(node.id, n);
+        place(n);
+    }
+}
+
+} // namespace quantflow
@@ -0,0 +1,286 @@
+#include "quantflow/execution/fill_simulator.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace quantflow {
+namespace execution {
+
+FillSimulator::FillSimulator(const FillSimulatorConfig& config)
+    : config_(config) {}
+
+void FillSimulator::submit(Order& order, const Bar* bar, std::vector<SimulatedFill>& fills) {
+    SymbolBook& book = books_[order.symbol];
+
+    if (bar && bar->symbol == order.symbol) {
+        if (!fill_at_close(book, order, *bar, fills)) {
+            rest(book, order);
+        }
+    } else {
+        book.arrived.push_back(&order);
+    }
+}
+
+void FillSimulator::match(const Bar& bar, std::vector<SimulatedFill>& fills) {
+    auto it = books_.find(bar.symbol);
+    if (it == books_.end()) return;
+
+    SymbolBook& book = it->second;
+    reset_budget(book, bar);
+
+    // Orders placed before this bar join the books; those placed at its
+    // timestamp were decided on its close and must not see its range
+    size_t same_bar = 0;
+    for (Order* order : book.arrived) {
+        if (!order->is_open()) continue;
+        if (order->created_at < bar.timestamp) {
+            rest(book, *order);
+        } else {
+            book.arrived[same_bar++] = order;
+        }
+    }
+    book.arrived.resize(same_bar);
+
+    trigger_stops(book, book.buy_stops,
+        [&bar](double stop) { return stop <= bar.high; }, bar, fills);
+    trigger_stops(book, book.sell_stops,
+        [&bar](double stop) { return stop >= bar.low; }, bar, fills);
+
+    while (!book.market.empty()) {
+        Order* order = book.market.front();
+        if (!order->is_open() || fill(book, *order, bar.open, true, fills)) {
+            book.market.pop_front();
+        } else {
+            break;
+        }
+    }
+
+    match_limits(book, book.buy_limits,
+        [&bar](double price) { return price >= bar.low; }, bar, fills);
+    match_limits(book, book.sell_limits,
+        [&bar](double price) { return price <= bar.high; }, bar, fills);
+
+    for (Order* order : book.arrived) {
+        if (!fill_at_close(book, *order, bar, fills)) {
+            rest(book, *order);
+        }
+    }
+    book.arrived.clear();
+}
+
+void FillSimulator::clear() {
+    books_.clear();
+}
+
+size_t FillSimulator::num_resting(const Symbol& symbol) const {
+    auto it = books_.find(symbol);
+    if (it == books_.end()) return 0;
+
+    const SymbolBook& book = it->second;
+    return book.arrived.size() + book.market.size() + book.buy_limits.size() +
+           book.sell_limits.size() + book.buy_stops.size() + book.sell_stops.size();
+}
+
+namespace {
+
+const Order* order_of(const Order* order) { return order; }
+
+template<typename Key>
+const Order* order_of(const std::pair<const Key, Order*>& entry) { return entry.second; }
+
+template<typename Queue>
+void write_queue(utils::BinaryWriter& out, const Queue& queue) {
+    uint64_t count = 0;
+    for (const auto& entry : queue) {
+        count += order_of(entry)->is_open() ? 1 : 0;
+    }
+    out.write(count);
+    for (const auto& entry : queue) {
+        if (order_of(entry)->is_open()) {
+            out.write(order_of(entry)->id);
+        }
+    }
+}
+
+template<typename Fn>
+void read_queue(utils::BinaryReader& in, std::unordered_map<OrderID, Order*>& orders, Fn&& place) {
+    uint64_t count = in.read<uint64_t>();
+    for (uint64_t i = 0; i < count; ++i) {
+        auto it = orders.find(in.read<OrderID>());
+        if (it == orders.end()) {
+            throw std::runtime_error("Fill simulator state names an unknown order");
+        }
+        place(*it->second);
+    }
+}
+
+} // namespace
+
+void FillSimulator::save_state(utils::BinaryWriter& out) const {
+    out.write<uint64_t>(books_.size());
+    for (const auto& [symbol, book] : books_) {
+        out.write_string(symbol);
+        write_queue(out, book.arrived);
+        write_queue(out, book.market);
+        write_queue(out, book.buy_limits);
+        write_queue(out, book.sell_limits);
+        write_queue(out, book.buy_stops);
+        write_queue(out, book.sell_stops);
+    }
+}
+
+void FillSimulator::load_state(utils::BinaryReader& in, std::unordered_map<OrderID, Order*>& orders) {
+    books_.clear();
+    uint64_t num_books = in.read<uint64_t>();
+    for (uint64_t i = 0; i < num_books; ++i) {
+        SymbolBook& book = books_[in.read_string()];
+        read_queue(in, orders, [&](Order& o) { book.arrived.push_back(&o); });
+        read_queue(in, orders, [&](Order& o) { book.market.push_back(&o); });
+        read_queue(in, orders, [&](Order& o) { book.buy_limits.emplace(o.price, &o); });
+        read_queue(in, orders, [&](Order& o) { book.sell_limits.emplace(o.price, &o); });
+        read_queue(in, orders, [&](Order& o) { book.buy_stops.emplace(o.stop_price, &o); });
+        read_queue(in, orders, [&](Order& o) { book.sell_stops.emplace(o.stop_price, &o); });
+    }
+}
+
+void FillSimulator::reset_budget(SymbolBook& book, const Bar& bar) const {
+    if (book.budget_time != bar.timestamp) {
+        book.budget_time = bar.timestamp;
+        book.budget = config_.max_participation * static_cast<double>(bar.volume);
+    }
+}
+
+bool FillSimulator::fill_at_close(SymbolBook& book, Order& order, const Bar& bar,
+                                  std::vector<SimulatedFill>& fills) {
+    reset_budget(book, bar);
+
+    double close = bar.close;
+    bool buy = order.is_buy();
+
+    if (order.type == OrderType::STOP || order.type == OrderType::STOP_LIMIT) {
+        bool triggered = buy ? close >= order.stop_price : close <= order.stop_price;
+        if (triggered) {
+            order.type = (order.type == OrderType::STOP) ? OrderType::MARKET : OrderType::LIMIT;
+        }
+    }
+
+    if (order.type == OrderType::MARKET) {
+        return fill(book, order, close, true, fills);
+    }
+    if (order.type == OrderType::LIMIT && (buy ? close <= order.price : close >= order.price)) {
+        return fill(book, order, close, false, fills);
+    }
+    return false;
+}
+
+void FillSimulator::rest(SymbolBook& book, Order& order) {
+    bool buy = order.is_buy();
+
+    switch (order.type) {
+        case OrderType::MARKET:
+            book.market.push_back(&order);
+            break;
+        case OrderType::LIMIT:
+            if (buy) book.buy_limits.emplace(order.price, &order);
+            else book.sell_limits.emplace(order.price, &order);
+            break;
+        case OrderType::STOP:
+        case OrderType::STOP_LIMIT:
+            if (buy) book.buy_stops.emplace(order.stop_price, &order);
+            else book.sell_stops.emplace(order.stop_price, &order);
+            break;
+    }
+}
+
+bool FillSimulator::fill(SymbolBook& book, Order& order, double price, bool marketable,
+                         std::vector<SimulatedFill>& fills) const {
+    double quantity = order.remaining_quantity;
+    if (config_.max_participation > 0.0) {
+        quantity = std::min(quantity, book.budget);
+    }
+    if (quantity <= constants::EPSILON) {
+        return false;
+    }
+
+    double fill_price = price;
+    double slippage = 0.0;
+    if (marketable) {
+        double adjustment = price * config_.slippage_bps / 10000.0;
+        fill_price = order.is_buy() ? price + adjustment : price - adjustment;
+        slippage = adjustment * quantity;
+    }
+
+    if (config_.max_participation > 0.0) {
+        book.budget -= quantity;
+    }
+
+    order.avg_fill_price = (order.avg_fill_price * order.filled_quantity + fill_price * quantity) /
+                           (order.filled_quantity + quantity);
+    order.filled_quantity += quantity;
+    order.remaining_quantity -= quantity;
+
+    bool done = order.remaining_quantity <= constants::EPSILON;
+    if (done) {
+        order.remaining_quantity = 0.0;
+        order.status = OrderStatus::FILLED;
+    } else {
+        order.status = OrderStatus::PARTIALLY_FILLED;
+    }
+
+    fills.push_back({&order, fill_price, quantity, slippage});
+    return done;
+}
+
+template<typename Book, typename Triggered>
+void FillSimulator::trigger_stops(SymbolBook& book, Book& stops, Triggered&& triggered,
+                                  const Bar& bar, std::vector<SimulatedFill>& fills) {
+    while (!stops.empty() && triggered(stops.begin()->first)) {
+        Order* order = stops.begin()->second;
+        stops.erase(stops.begin());
+
+        if (!order->is_open()) continue;
+
+        // Gap through the stop trades at the open, otherwise at the stop
+        bool buy = order->is_buy();
+        double trigger = buy ? std::max(bar.open, order->stop_price)
+                             : std::min(bar.open, order->stop_price);
+
+        if (order->type == OrderType::STOP) {
+            order->type = OrderType::MARKET;
+            if (!fill(book, *order, trigger, true, fills)) {
+                book.market.push_back(order);
+            }
+            continue;
+        }
+
+        // STOP_LIMIT: a limit from the trigger onwards
+        order->type = OrderType::LIMIT;
+        bool crossed = buy ? bar.low <= order->price : bar.high >= order->price;
+        double price = buy ? std::min(order->price, trigger) : std::max(order->price, trigger);
+        if (!crossed || !fill(book, *order, price, false, fills)) {
+            rest(book, *order);
+        }
+    }
+}
+
+template<typename Book, typename Crossed>
+void FillSimulator::match_limits(SymbolBook& book, Book& limits, Crossed&& crossed,
+                                 const Bar& bar, std::vector<SimulatedFill>& fills) {
+    while (!limits.empty() && crossed(limits.begin()->first)) {
+        Order* order = limits.begin()->second;
+
+        if (!order->is_open()) {
+            limits.erase(limits.begin());
+            continue;
+        }
+
+        double price = order->is_buy() ? std::min(order->price, bar.open)
+                                       : std::max(order->price, bar.open);
+        if (!fill(book, *order, price, false, fills)) {
+            break;  // bar volume budget exhausted
+        }
+        limits.erase(limits.begin());
+    }
+}
+
+} // namespace execution
+} // namespace quantflow
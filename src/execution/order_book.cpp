@@ -0,0 +1,459 @@
+#include "quantflow/execution/order_book.hpp"
+#include "quantflow/utils/bits.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace quantflow {
+namespace execution {
+
+// ---------------------------------------------------------------------------
+// IdIndex
+
+LimitOrderBook::IdIndex::IdIndex(size_t max_entries) : size_(0) {
+    size_t capacity = 16;
+    while (capacity < max_entries * 2) {
+        capacity <<= 1;
+    }
+    keys_.assign(capacity, 0);
+    values_.assign(capacity, NIL);
+    mask_ = capacity - 1;
+}
+
+void LimitOrderBook::IdIndex::grow() {
+    std::vector<OrderID> keys(keys_.size() * 2, 0);
+    std::vector<uint32_t> values(keys.size(), NIL);
+    keys.swap(keys_);
+    values.swap(values_);
+    mask_ = keys_.size() - 1;
+
+    for (size_t j = 0; j < keys.size(); ++j) {
+        if (keys[j] == 0) continue;
+        size_t i = slot_of(keys[j]);
+        while (keys_[i] != 0) {
+            i = (i + 1) & mask_;
+        }
+        keys_[i] = keys[j];
+        values_[i] = values[j];
+    }
+}
+
+size_t LimitOrderBook::IdIndex::slot_of(OrderID id) const {
+    uint64_t h = id * 0x9E3779B97F4A7C15ull;
+    return static_cast<size_t>(h ^ (h >> 32)) & mask_;
+}
+
+bool LimitOrderBook::IdIndex::insert(OrderID id, uint32_t node) {
+    if ((size_ + 1) * 2 > keys_.size()) {
+        grow();
+    }
+
+    size_t i = slot_of(id);
+    while (keys_[i] != 0) {
+        if (keys_[i] == id) return false;
+        i = (i + 1) & mask_;
+    }
+    keys_[i] = id;
+    values_[i] = node;
+    ++size_;
+    return true;
+}
+
+uint32_t LimitOrderBook::IdIndex::find(OrderID id) const {
+    size_t i = slot_of(id);
+    while (keys_[i] != 0) {
+        if (keys_[i] == id) return values_[i];
+        i = (i + 1) & mask_;
+    }
+    return NIL;
+}
+
+void LimitOrderBook::IdIndex::erase(OrderID id) {
+    size_t i = slot_of(id);
+    while (keys_[i] != id) {
+        if (keys_[i] == 0) return;
+        i = (i + 1) & mask_;
+    }
+    keys_[i] = 0;
+    --size_;
+
+    // Shift back later entries of the probe run so lookups stay tombstone-free
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask_;
+        if (keys_[j] == 0) return;
+
+        size_t home = slot_of(keys_[j]);
+        bool movable = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (movable) {
+            keys_[i] = keys_[j];
+            values_[i] = values_[j];
+            keys_[j] = 0;
+            i = j;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Side
+
+LimitOrderBook::Level& LimitOrderBook::Side::touch(uint32_t i) {
+    std::unique_ptr<Level[]>& page = pages[i >> PAGE_BITS];
+    if (!page) {
+        page = std::make_unique<Level[]>(PAGE_LEVELS);
+    }
+    return page[i & (PAGE_LEVELS - 1)];
+}
+
+const LimitOrderBook::Level* LimitOrderBook::Side::find(uint32_t i) const {
+    const std::unique_ptr<Level[]>& page = pages[i >> PAGE_BITS];
+    return page ? &page[i & (PAGE_LEVELS - 1)] : nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// LimitOrderBook
+
+LimitOrderBook::LimitOrderBook(const OrderBookConfig& config)
+    : config_(config),
+      free_head_(NIL),
+      index_(std::min(config.initial_orders, config.max_orders)),
+      next_sequence_(1),
+      num_orders_(0),
+      best_bid_(-1),
+      best_ask_(static_cast<int64_t>(config.num_levels)) {
+    if (config.num_levels == 0 || config.num_levels >= NIL || config.max_orders >= NIL) {
+        throw std::invalid_argument("Order book size out of range");
+    }
+    if (config.tick_size <= 0.0) {
+        throw std::invalid_argument("Order book tick size must be positive");
+    }
+
+    size_t words = (config.num_levels + 63) / 64;
+    for (Side* s : {&bids_, &asks_}) {
+        s->pages.resize((config.num_levels + PAGE_LEVELS - 1) >> PAGE_BITS);
+        s->bits.assign(words, 0);
+    }
+
+    nodes_.reserve(std::min(config.initial_orders, config.max_orders));
+    grow_pool();
+}
+
+bool LimitOrderBook::grow_pool() {
+    size_t old_size = nodes_.size();
+    size_t new_size = old_size > 0 ? old_size * 2 : std::max<size_t>(nodes_.capacity(), 1);
+    new_size = std::min(new_size, config_.max_orders);
+    if (new_size <= old_size) return false;
+
+    nodes_.resize(new_size);
+    for (size_t i = new_size; i-- > old_size;) {
+        nodes_[i].next = free_head_;
+        free_head_ = static_cast<uint32_t>(i);
+    }
+    return true;
+}
+
+bool LimitOrderBook::to_level(double price, uint32_t& level) const {
+    long long offset = std::llround((price - config_.min_price) / config_.tick_size);
+    if (offset < 0 || offset >= static_cast<long long>(config_.num_levels)) {
+        return false;
+    }
+    level = static_cast<uint32_t>(offset);
+    return true;
+}
+
+double LimitOrderBook::to_price(uint32_t level) const {
+    return config_.min_price + level * config_.tick_size;
+}
+
+bool LimitOrderBook::add(OrderID id, bool is_buy, double price, uint64_t quantity) {
+    uint32_t level;
+    if (quantity == 0 || !to_level(price, level)) return false;
+    return insert(id, is_buy, level, quantity, false) != NIL;
+}
+
+bool LimitOrderBook::cancel(OrderID id) {
+    uint32_t node = index_.find(id);
+    if (node == NIL) return false;
+    take(node, nodes_[node].quantity);
+    return true;
+}
+
+bool LimitOrderBook::reduce(OrderID id, uint64_t quantity) {
+    uint32_t node = index_.find(id);
+    if (node == NIL) return false;
+    take(node, quantity);
+    return true;
+}
+
+bool LimitOrderBook::execute(OrderID id, uint64_t quantity, std::vector<BookFill>& fills) {
+    uint32_t node = index_.find(id);
+    if (node == NIL) return false;
+
+    fill_own_ahead(node, quantity, fills);
+    take(node, quantity);
+    return true;
+}
+
+bool LimitOrderBook::add_own(OrderID id, bool is_buy, double price, uint64_t quantity,
+                             std::vector<BookFill>& fills) {
+    if (quantity == 0 || index_.find(id) != NIL) return false;
+
+    bool market = price <= 0.0;
+    uint32_t limit = 0;
+    if (!market && !to_level(price, limit)) return false;
+
+    // Cross the spread against resting liquidity in price-time order
+    Side& opposite = side(!is_buy);
+    while (quantity > 0) {
+        int64_t best = is_buy ? best_ask_ : best_bid_;
+        bool empty = is_buy ? best >= static_cast<int64_t>(config_.num_levels) : best < 0;
+        if (empty) break;
+        if (!market && (is_buy ? best > limit : best < limit)) break;
+
+        uint32_t maker = opposite.at(static_cast<uint32_t>(best)).head;
+        uint64_t traded = std::min(quantity, nodes_[maker].quantity);
+        double trade_price = to_price(static_cast<uint32_t>(best));
+
+        fills.push_back({id, trade_price, traded, false});
+        if (nodes_[maker].own) {
+            fills.push_back({nodes_[maker].id, trade_price, traded, true});
+        }
+
+        take(maker, traded);
+        quantity -= traded;
+    }
+
+    if (quantity > 0 && !market) {
+        return insert(id, is_buy, limit, quantity, true) != NIL;
+    }
+    return true;
+}
+
+bool LimitOrderBook::contains(OrderID id) const {
+    return index_.find(id) != NIL;
+}
+
+uint64_t LimitOrderBook::queue_ahead(OrderID id) const {
+    uint32_t node = index_.find(id);
+    return (node != NIL && nodes_[node].own) ? ahead_of(nodes_[node]) : 0;
+}
+
+uint64_t LimitOrderBook::remaining(OrderID id) const {
+    uint32_t node = index_.find(id);
+    return (node != NIL) ? nodes_[node].quantity : 0;
+}
+
+double LimitOrderBook::best_bid() const {
+    return (best_bid_ >= 0) ? to_price(static_cast<uint32_t>(best_bid_)) : 0.0;
+}
+
+double LimitOrderBook::best_ask() const {
+    return (best_ask_ < static_cast<int64_t>(config_.num_levels))
+        ? to_price(static_cast<uint32_t>(best_ask_)) : 0.0;
+}
+
+double LimitOrderBook::mid_price() const {
+    if (best_bid_ < 0 || best_ask_ >= static_cast<int64_t>(config_.num_levels)) return 0.0;
+    return (best_bid() + best_ask()) / 2.0;
+}
+
+uint64_t LimitOrderBook::depth_at(bool is_buy, double price) const {
+    uint32_t index;
+    if (!to_level(price, index)) return 0;
+    const Level* level = side(is_buy).find(index);
+    return level ? level->quantity : 0;
+}
+
+void LimitOrderBook::snapshot(OrderBook& out, size_t max_levels) const {
+    out.bids.clear();
+    out.asks.clear();
+
+    for (int64_t i = best_bid_; i >= 0 && out.bids.size() < max_levels; --i) {
+        const Level* level = bids_.find(static_cast<uint32_t>(i));
+        if (level && level->count > 0) {
+            out.bids.push_back({to_price(static_cast<uint32_t>(i)), level->quantity, level->count});
+        }
+    }
+
+    for (int64_t i = best_ask_;
+         i < static_cast<int64_t>(config_.num_levels) && out.asks.size() < max_levels; ++i) {
+        const Level* level = asks_.find(static_cast<uint32_t>(i));
+        if (level && level->count > 0) {
+            out.asks.push_back({to_price(static_cast<uint32_t>(i)), level->quantity, level->count});
+        }
+    }
+}
+
+uint32_t LimitOrderBook::insert(OrderID id, bool is_buy, uint32_t level_index,
+                                uint64_t quantity, bool own) {
+    if (id == 0) return NIL;
+    if (free_head_ == NIL && !grow_pool()) return NIL;
+
+    uint32_t n = free_head_;
+    if (!index_.insert(id, n)) return NIL;
+    free_head_ = nodes_[n].next;
+
+    Side& s = side(is_buy);
+    Level& level = s.touch(level_index);
+
+    Node& node = nodes_[n];
+    node.id = id;
+    node.quantity = quantity;
+    node.sequence = next_sequence_++;
+    node.ahead = level.quantity;
+    node.mark = level.front_removed;
+    node.level = level_index;
+    node.prev = level.tail;
+    node.next = NIL;
+    node.own_prev = NIL;
+    node.own_next = NIL;
+    node.is_buy = is_buy;
+    node.own = own;
+
+    if (level.tail != NIL) {
+        nodes_[level.tail].next = n;
+    } else {
+        level.head = n;
+    }
+    level.tail = n;
+    level.quantity += quantity;
+    level.count++;
+
+    if (own) {
+        node.own_prev = level.own_tail;
+        if (level.own_tail != NIL) {
+            nodes_[level.own_tail].own_next = n;
+        } else {
+            level.own_head = n;
+        }
+        level.own_tail = n;
+    }
+
+    s.bits[level_index >> 6] |= uint64_t{1} << (level_index & 63);
+    if (is_buy) {
+        best_bid_ = std::max<int64_t>(best_bid_, level_index);
+    } else {
+        best_ask_ = std::min<int64_t>(best_ask_, level_index);
+    }
+
+    ++num_orders_;
+    return n;
+}
+
+void LimitOrderBook::take(uint32_t n, uint64_t quantity) {
+    Node& node = nodes_[n];
+    quantity = std::min(quantity, node.quantity);
+
+    Level& level = side(node.is_buy).at(node.level);
+    level.quantity -= quantity;
+    node.quantity -= quantity;
+
+    // Own orders queued behind this one move up: all of them through the
+    // level's counter when it is in front of every one, otherwise only
+    // those behind it, walking back from the last
+    if (level.own_head != NIL) {
+        if (node.sequence < nodes_[level.own_head].sequence) {
+            level.front_removed += quantity;
+        } else {
+            for (uint32_t own = level.own_tail;
+                 own != NIL && nodes_[own].sequence > node.sequence; own = nodes_[own].own_prev) {
+                Node& o = nodes_[own];
+                o.ahead = ahead_of(o) - std::min(ahead_of(o), quantity);
+                o.mark = level.front_removed;
+            }
+        }
+    }
+
+    if (node.quantity == 0) {
+        unlink(n);
+    }
+}
+
+uint64_t LimitOrderBook::ahead_of(const Node& node) const {
+    uint64_t moved = side(node.is_buy).at(node.level).front_removed - node.mark;
+    return node.ahead - std::min(node.ahead, moved);
+}
+
+void LimitOrderBook::unlink(uint32_t n) {
+    Node& node = nodes_[n];
+    Side& s = side(node.is_buy);
+    Level& level = s.at(node.level);
+
+    if (node.prev != NIL) nodes_[node.prev].next = node.next;
+    else level.head = node.next;
+    if (node.next != NIL) nodes_[node.next].prev = node.prev;
+    else level.tail = node.prev;
+    level.count--;
+
+    if (node.own) {
+        if (node.own_prev != NIL) nodes_[node.own_prev].own_next = node.own_next;
+        else level.own_head = node.own_next;
+        if (node.own_next != NIL) nodes_[node.own_next].own_prev = node.own_prev;
+        else level.own_tail = node.own_prev;
+    }
+
+    if (level.count == 0) {
+        s.bits[node.level >> 6] &= ~(uint64_t{1} << (node.level & 63));
+        int64_t best = node.is_buy ? best_bid_ : best_ask_;
+        if (best == node.level) {
+            refresh_best(node.is_buy);
+        }
+    }
+
+    index_.erase(node.id);
+    node.next = free_head_;
+    free_head_ = n;
+    --num_orders_;
+}
+
+void LimitOrderBook::refresh_best(bool is_buy) {
+    const std::vector<uint64_t>& bits = side(is_buy).bits;
+
+    if (is_buy) {
+        int64_t word = best_bid_ >> 6;
+        uint64_t mask = bits[word] & (~uint64_t{0} >> (63 - (best_bid_ & 63)));
+        while (mask == 0) {
+            if (--word < 0) {
+                best_bid_ = -1;
+                return;
+            }
+            mask = bits[word];
+        }
+        best_bid_ = (word << 6) + utils::highest_bit(mask);
+    } else {
+        int64_t words = static_cast<int64_t>(bits.size());
+        int64_t word = best_ask_ >> 6;
+        uint64_t mask = bits[word] & (~uint64_t{0} << (best_ask_ & 63));
+        while (mask == 0) {
+            if (++word >= words) {
+                best_ask_ = static_cast<int64_t>(config_.num_levels);
+                return;
+            }
+            mask = bits[word];
+        }
+        best_ask_ = (word << 6) + utils::lowest_bit(mask);
+    }
+}
+
+void LimitOrderBook::fill_own_ahead(uint32_t n, uint64_t quantity, std::vector<BookFill>& fills) {
+    const Node& node = nodes_[n];
+    if (node.own) return;
+
+    double price = to_price(node.level);
+    uint32_t own = side(node.is_buy).at(node.level).own_head;
+
+    // The own list is in queue order, so stop at the first one behind node
+    while (own != NIL && quantity > 0 && nodes_[own].sequence < node.sequence) {
+        uint32_t next = nodes_[own].own_next;
+
+        uint64_t traded = std::min(quantity, nodes_[own].quantity);
+        fills.push_back({nodes_[own].id, price, traded, true});
+        take(own, traded);
+        quantity -= traded;
+
+        own = next;
+    }
+}
+
+} // namespace execution
+} // namespace quantflow
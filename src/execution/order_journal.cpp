@@ -0,0 +1,246 @@
+#include "quantflow/execution/order_journal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace quantflow {
+namespace execution {
+
+namespace {
+
+size_t page_size() {
+    return utils::MappedFile::page_size();
+}
+
+size_t align8(size_t size) {
+    return (size + 7) & ~size_t{7};
+}
+
+size_t align_page(size_t size) {
+    return (size + page_size() - 1) & ~(page_size() - 1);
+}
+
+} // namespace
+
+OrderJournal::OrderJournal(const OrderJournalConfig& config)
+    : config_(config),
+      file_(config.path, align_page(config.max_size)),
+      base_(nullptr),
+      capacity_(0),
+      recovered_end_(sizeof(FileHeader)),
+      written_(sizeof(FileHeader)),
+      commit_requested_(false),
+      stopping_(false),
+      synced_(0),
+      sync_error_(0) {
+    size_t file_size = file_.file_size();
+    size_t capacity = align_page(std::max(config.initial_size, sizeof(FileHeader) + page_size()));
+    while (capacity < file_size) {
+        capacity *= 2;
+    }
+    grow(capacity);
+
+    FileHeader header;
+    std::memcpy(&header, base_, sizeof(header));
+    if (file_size == 0 || (header.magic == 0 && header.version == 0)) {
+        header = FileHeader{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        std::memcpy(base_, &header, sizeof(header));
+    } else if (header.magic != MAGIC || header.version != VERSION) {
+        throw std::runtime_error("Not an order journal: " + config.path);
+    }
+
+    recovered_end_ = scan();
+
+    // Whatever follows the recovered entries (a torn entry, and older
+    // entries behind it) is cut off before appending resumes there. Left in
+    // place, a later append could end exactly on a stale but intact entry
+    // and the next recovery would replay it over newer state.
+    if (recovered_end_ < file_size) {
+        if (!file_.truncate(recovered_end_)) {
+            throw std::runtime_error("Failed to truncate order journal: " + config.path);
+        }
+        grow(capacity);
+    }
+    written_.store(recovered_end_, std::memory_order_release);
+    synced_ = recovered_end_;
+
+    flusher_ = std::thread(&OrderJournal::flush_loop, this);
+}
+
+OrderJournal::~OrderJournal() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    flusher_.join();
+
+    // Trim the unused tail so the next open maps only what it needs. A
+    // failure is harmless: recovery stops at the first empty entry anyway.
+    file_.truncate(written_.load(std::memory_order_acquire));
+}
+
+// Sizes the file to `capacity` and maps it. Where the mapping stays put,
+// the flusher keeps msyncing the pages already mapped meanwhile; where it
+// moves, growing waits for the flusher to finish its pass.
+void OrderJournal::grow(size_t capacity) {
+    if constexpr (utils::MappedFile::grows_in_place) {
+        file_.resize(capacity);
+        base_ = file_.data();
+        capacity_ = capacity;
+    } else {
+        std::lock_guard<std::mutex> lock(mutex_);
+        file_.resize(capacity);
+        base_ = file_.data();
+        capacity_ = capacity;
+    }
+}
+
+uint64_t OrderJournal::checksum(const char* data, size_t size) {
+    // Word-at-a-time FNV-style mix; payloads are padded to 8 bytes
+    uint64_t hash = 0xCBF29CE484222325ull ^ size;
+    for (size_t i = 0; i < size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+size_t OrderJournal::scan() const {
+    size_t offset = sizeof(FileHeader);
+
+    while (offset + sizeof(EntryHeader) <= capacity_) {
+        EntryHeader header;
+        std::memcpy(&header, base_ + offset, sizeof(header));
+
+        if (header.size < sizeof(EntryHeader) || (header.size & 7) != 0 ||
+            offset + header.size > capacity_) {
+            break;
+        }
+        const char* payload = base_ + offset + sizeof(EntryHeader);
+        if (checksum(payload, header.size - sizeof(EntryHeader)) != header.checksum) {
+            break;
+        }
+        offset += header.size;
+    }
+    return offset;
+}
+
+char* OrderJournal::reserve(size_t size) {
+    size_t offset = written_.load(std::memory_order_relaxed);
+
+    // Keep room for an empty terminating header after every entry
+    if (offset + size + sizeof(EntryHeader) > capacity_) {
+        size_t capacity = capacity_ * 2;
+        while (offset + size + sizeof(EntryHeader) > capacity) {
+            capacity *= 2;
+        }
+        size_t reserved = align_page(config_.max_size);
+        if (capacity > reserved) {
+            if (offset + size + sizeof(EntryHeader) > reserved) {
+                throw std::runtime_error("Order journal exceeds max_size: " + config_.path);
+            }
+            capacity = reserved;
+        }
+        grow(capacity);
+    }
+    return base_ + offset;
+}
+
+void OrderJournal::append(EntryType type, const void* payload, size_t size) {
+    size_t total = sizeof(EntryHeader) + align8(size);
+    char* entry = reserve(total);
+    char* body = entry + sizeof(EntryHeader);
+
+    std::memcpy(body, payload, size);
+    std::memset(body + size, 0, align8(size) - size);
+
+    EntryHeader header{};
+    header.size = static_cast<uint32_t>(total);
+    header.type = static_cast<uint16_t>(type);
+    header.checksum = checksum(body, align8(size));
+    std::memcpy(entry, &header, sizeof(header));
+
+    written_.store(written_.load(std::memory_order_relaxed) + total, std::memory_order_release);
+}
+
+void OrderJournal::append_order(const OrderRecord& record) {
+    append(EntryType::ORDER, &record, sizeof(record));
+}
+
+void OrderJournal::append_fill(const FillRecord& fill) {
+    append(EntryType::FILL, &fill, sizeof(fill));
+}
+
+void OrderJournal::append_string(StringHandle handle, std::string_view str) {
+    char buffer[256];
+    size_t size = 2 * sizeof(uint32_t) + str.size();
+
+    std::string large;
+    char* payload = buffer;
+    if (size > sizeof(buffer)) {
+        large.resize(size);
+        payload = &large[0];
+    }
+
+    uint32_t length = static_cast<uint32_t>(str.size());
+    std::memcpy(payload, &handle, sizeof(handle));
+    std::memcpy(payload + sizeof(handle), &length, sizeof(length));
+    std::memcpy(payload + 2 * sizeof(uint32_t), str.data(), str.size());
+    append(EntryType::STRING, payload, size);
+}
+
+void OrderJournal::commit() {
+    commit_requested_.store(true, std::memory_order_release);
+    wake_.notify_one();
+}
+
+void OrderJournal::sync() {
+    size_t target = written_.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    commit_requested_.store(true, std::memory_order_release);
+    wake_.notify_one();
+    synced_cv_.wait(lock, [this, target] {
+        return synced_ >= target || sync_error_ != 0 || stopping_;
+    });
+    if (sync_error_ != 0) {
+        throw std::runtime_error("Order journal writeback failed: " + config_.path + ": " +
+                                 utils::MappedFile::describe(sync_error_));
+    }
+}
+
+void OrderJournal::flush_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto interval = std::chrono::nanoseconds(config_.commit_interval);
+
+    while (!stopping_) {
+        wake_.wait_for(lock, interval, [this] {
+            return stopping_ || commit_requested_.load(std::memory_order_acquire);
+        });
+        commit_requested_.store(false, std::memory_order_relaxed);
+        flush_locked();
+    }
+    flush_locked();
+}
+
+void OrderJournal::flush_locked() {
+    size_t end = written_.load(std::memory_order_acquire);
+    if (end <= synced_) return;
+
+    // A failed writeback may have dropped pages, so the error sticks: later
+    // passes keep retrying, but nothing after it is reported durable
+    size_t from = synced_ & ~(page_size() - 1);
+    if (int error = file_.flush(from, end - from)) {
+        sync_error_ = error;
+    } else if (sync_error_ == 0) {
+        synced_ = end;
+    }
+    synced_cv_.notify_all();
+}
+
+} // namespace execution
+} // namespace quantflow
@@ -1,132 +1,683 @@
 #include "quantflow/execution/order_manager.hpp"
 #include "quantflow/core/time.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
 
 namespace quantflow {
 namespace execution {
 
-OrderManager::OrderManager() : next_order_id_(1) {}
+OrderManager::OrderManager(const OrderManagerConfig& config)
+    : config_(config),
+      slab_table_(new std::atomic<Slot*>[MAX_SLABS]),
+      id_cursor_(1),
+      num_orders_(0),
+      open_count_(0),
+      num_strings_(1),
+      journaled_strings_(1),
+      recovering_(false),
+      deferred_(nullptr),
+      notifying_(true),
+      dropped_(0),
+      publish_ns_total_(0),
+      publish_ns_max_(0),
+      num_producers_(0),
+      owner_strings_(*this),
+      owner_ids_(*this),
+      running_(false) {
+    if (config.queue_capacity < 2 || (config.queue_capacity & (config.queue_capacity - 1)) != 0) {
+        throw std::invalid_argument("OrderManager queue capacity must be a power of two");
+    }
+    config_.id_block = std::max<size_t>(config.id_block, 1);
+    
+    for (size_t i = 0; i < MAX_SLABS; ++i) {
+        slab_table_[i].store(nullptr, std::memory_order_relaxed);
+    }
+    
+    slabs_.reserve((config.expected_orders >> SLAB_BITS) + 1);
+    for (OrderID id = 0; id < config.expected_orders; id += SLAB_SIZE) {
+        allocate(id);
+    }
+    producers_.reserve(config.max_producers);
+    
+    if (!config.journal.path.empty()) {
+        journal_ = std::make_unique<OrderJournal>(config.journal);
+        recover();
+    }
+}
+
+OrderManager::~OrderManager() {
+    stop();
+    stop_subscribers();
+}
+
+// ---------------------------------------------------------------------------
+// Owner-thread entry points
+
+OrderID OrderManager::submit_order(const Order& order) {
+    Command command{};
+    command.kind = Command::Kind::SUBMIT;
+    fill_record(command.order, order, owner_strings_);
+    command.order.id = owner_ids_.next();
+    command.order.created_at = TimeUtils::now();
+    apply(command);
+    return command.order.id;
+}
+
+void OrderManager::cancel_order(OrderID order_id) {
+    Command command{};
+    command.kind = Command::Kind::CANCEL;
+    command.order.id = order_id;
+    command.order.updated_at = TimeUtils::now();
+    apply(command);
+}
+
+void OrderManager::modify_order(OrderID order_id, double new_price, double new_quantity) {
+    Command command{};
+    command.kind = Command::Kind::MODIFY;
+    command.order.id = order_id;
+    command.order.price = new_price;
+    command.order.quantity = new_quantity;
+    command.order.updated_at = TimeUtils::now();
+    apply(command);
+}
 
-OrderID OrderManager::submit_order(Order order) {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::vector<OrderID> OrderManager::submit_orders(const std::vector<Order>& orders) {
+    std::vector<OrderID> ids(orders.size());
+    if (orders.empty()) return ids;
     
-    order.id = next_order_id_++;
-    order.created_at = TimeUtils::now();
-    order.status = OrderStatus::SUBMITTED;
-    order.filled_quantity = 0.0;
-    order.remaining_quantity = order.quantity;
+    Timestamp now = TimeUtils::now();
+    OrderID first = id_cursor_.fetch_add(orders.size(), std::memory_order_acq_rel);
     
-    orders_[order.id] = order;
+    std::vector<OrderID>* outer = deferred_;
+    std::vector<OrderID> changed;
+    changed.reserve(orders.size());
+    deferred_ = &changed;
     
-    if (order_callback_) {
-        order_callback_(order);
+    Command command{};
+    command.kind = Command::Kind::SUBMIT;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        fill_record(command.order, orders[i], owner_strings_);
+        command.order.id = ids[i] = first + i;
+        command.order.created_at = now;
+        apply(command);
     }
     
-    return order.id;
+    deferred_ = outer;
+    notify(changed);
+    return ids;
 }
 
-void OrderManager::cancel_order(OrderID order_id) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void OrderManager::cancel_orders(const std::vector<OrderID>& order_ids) {
+    Timestamp now = TimeUtils::now();
     
-    auto it = orders_.find(order_id);
-    if (it != orders_.end() && it->second.is_open()) {
-        it->second.status = OrderStatus::CANCELLED;
-        it->second.updated_at = TimeUtils::now();
-        
-        if (order_callback_) {
-            order_callback_(it->second);
+    std::vector<OrderID>* outer = deferred_;
+    std::vector<OrderID> changed;
+    changed.reserve(order_ids.size());
+    deferred_ = &changed;
+    
+    Command command{};
+    command.kind = Command::Kind::CANCEL;
+    command.order.updated_at = now;
+    for (OrderID order_id : order_ids) {
+        command.order.id = order_id;
+        apply(command);
+    }
+    
+    deferred_ = outer;
+    notify(changed);
+}
+
+void OrderManager::update_order(const Order& order) {
+    Command command{};
+    command.kind = Command::Kind::UPDATE;
+    fill_record(command.order, order, owner_strings_);
+    apply(command);
+}
+
+void OrderManager::add_fill(const Fill& fill) {
+    Command command{};
+    command.kind = Command::Kind::FILL;
+    fill_record(command.fill, fill, owner_strings_);
+    apply(command);
+}
+
+OrderManager::Producer& OrderManager::create_producer() {
+    std::lock_guard<std::mutex> lock(producers_mutex_);
+    
+    // producers_ never reallocates, so the owner can index it while we add
+    if (producers_.size() >= config_.max_producers) {
+        throw std::runtime_error("OrderManager producer limit reached");
+    }
+    producers_.push_back(std::unique_ptr<Producer>(new Producer(*this)));
+    num_producers_.store(producers_.size(), std::memory_order_release);
+    return *producers_.back();
+}
+
+size_t OrderManager::process() {
+    size_t applied = 0;
+    size_t count = num_producers_.load(std::memory_order_acquire);
+    
+    Command command;
+    for (size_t i = 0; i < count; ++i) {
+        auto& queue = producers_[i]->queue_;
+        while (queue.pop(command)) {
+            apply(command);
+            ++applied;
         }
     }
+    return applied;
 }
 
-void OrderManager::modify_order(OrderID order_id, double new_price, double new_quantity) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = orders_.find(order_id);
-    if (it != orders_.end() && it->second.is_open()) {
-        it->second.price = new_price;
-        it->second.quantity = new_quantity;
-        it->second.remaining_quantity = new_quantity - it->second.filled_quantity;
-        it->second.updated_at = TimeUtils::now();
-        
-        if (order_callback_) {
-            order_callback_(it->second);
+void OrderManager::start() {
+    if (running_.exchange(true)) return;
+    
+    owner_ = std::thread([this] {
+        while (running_.load(std::memory_order_acquire)) {
+            if (process() == 0) {
+                std::this_thread::yield();
+            }
         }
+    });
+}
+
+void OrderManager::stop() {
+    if (!running_.exchange(false)) return;
+    
+    owner_.join();
+    process();
+}
+
+// ---------------------------------------------------------------------------
+// Owner-side state changes
+
+OrderManager::Slot* OrderManager::find(OrderID order_id) const {
+    size_t slab = order_id >> SLAB_BITS;
+    if (order_id == 0 || slab >= MAX_SLABS) return nullptr;
+    
+    Slot* slots = slab_table_[slab].load(std::memory_order_acquire);
+    return slots ? &slots[order_id & (SLAB_SIZE - 1)] : nullptr;
+}
+
+OrderManager::Slot& OrderManager::allocate(OrderID order_id) {
+    size_t slab = order_id >> SLAB_BITS;
+    if (slab >= MAX_SLABS) {
+        throw std::runtime_error("OrderManager order capacity exceeded");
+    }
+    
+    Slot* slots = slab_table_[slab].load(std::memory_order_relaxed);
+    if (!slots) {
+        slabs_.push_back(std::make_unique<Slot[]>(SLAB_SIZE));
+        slots = slabs_.back().get();
+        slab_table_[slab].store(slots, std::memory_order_release);
     }
+    return slots[order_id & (SLAB_SIZE - 1)];
 }
 
-void OrderManager::update_order(const Order& order) {
-    std::lock_guard<std::mutex> lock(mutex_);
+template<typename Fn>
+void OrderManager::write(Slot& slot, Fn&& fn) {
+    uint32_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    fn(slot.record);
+    slot.version.store(version + 2, std::memory_order_release);
+}
+
+OrderManager::Slot* OrderManager::find_live(OrderID order_id) const {
+    Slot* slot = find(order_id);
+    return (slot && slot->version.load(std::memory_order_relaxed) != 0) ? slot : nullptr;
+}
+
+template<typename Fn>
+void OrderManager::change(Slot& slot, Fn&& fn) {
+    bool was_open = slot.version.load(std::memory_order_relaxed) != 0 && slot.record.is_open();
+    StringHandle old_symbol = slot.record.symbol;
+    StringHandle old_strategy = slot.record.strategy_id;
+    
+    write(slot, std::forward<Fn>(fn));
+    
+    const OrderRecord& record = slot.record;
+    bool is_open = record.is_open();
+    bool moved = record.symbol != old_symbol || record.strategy_id != old_strategy;
+    
+    if (was_open && (!is_open || moved)) {
+        unindex(slot, old_symbol, old_strategy);
+    }
+    if (is_open && (!was_open || moved)) {
+        index(slot);
+    }
+    open_count_.store(open_ids_.size(), std::memory_order_relaxed);
+    
+    if (journal_ && !recovering_) {
+        journal_strings();
+        journal_->append_order(record);
+    }
     
-    orders_[order.id] = order;
+    if (deferred_) {
+        deferred_->push_back(record.id);
+    } else if (order_callback_) {
+        order_callback_(record);
+    }
     
-    if (order_callback_) {
-        order_callback_(order);
+    if (notifications_) {
+        Notification notification;
+        notification.kind = Notification::Kind::ORDER;
+        notification.order = record;
+        publish(notification);
     }
 }
 
-void OrderManager::add_fill(const Fill& fill) {
-    std::lock_guard<std::mutex> lock(mutex_);
+void OrderManager::notify(const std::vector<OrderID>& order_ids) {
+    if (!order_callback_) return;
     
-    fills_.push_back(fill);
+    for (OrderID order_id : order_ids) {
+        order_callback_(record(order_id));
+    }
+}
+
+void OrderManager::apply(const Command& command) {
+    const OrderRecord& request = command.order;
     
-    auto it = orders_.find(fill.order_id);
-    if (it != orders_.end()) {
-        Order& order = it->second;
-        order.filled_quantity += fill.quantity;
-        order.remaining_quantity = order.quantity - order.filled_quantity;
+    switch (command.kind) {
+        case Command::Kind::SUBMIT: {
+            Slot& slot = allocate(request.id);
+            num_orders_.fetch_add(1, std::memory_order_relaxed);
+            change(slot, [&request](OrderRecord& record) {
+                record = request;
+                record.status = OrderStatus::SUBMITTED;
+                record.filled_quantity = 0.0;
+                record.remaining_quantity = record.quantity;
+            });
+            break;
+        }
         
-        double total_value = order.avg_fill_price * (order.filled_quantity - fill.quantity) +
-                            fill.price * fill.quantity;
-        order.avg_fill_price = total_value / order.filled_quantity;
+        case Command::Kind::CANCEL: {
+            Slot* slot = find_live(request.id);
+            if (!slot || !slot->record.is_open()) break;
+            
+            change(*slot, [&request](OrderRecord& record) {
+                record.status = OrderStatus::CANCELLED;
+                record.updated_at = request.updated_at;
+            });
+            break;
+        }
         
-        if (order.remaining_quantity <= 0.0) {
-            order.status = OrderStatus::FILLED;
-            order.filled_at = fill.timestamp;
-        } else {
-            order.status = OrderStatus::PARTIALLY_FILLED;
+        case Command::Kind::MODIFY: {
+            Slot* slot = find_live(request.id);
+            if (!slot || !slot->record.is_open()) break;
+            
+            change(*slot, [&request](OrderRecord& record) {
+                record.price = request.price;
+                record.quantity = request.quantity;
+                record.remaining_quantity = request.quantity - record.filled_quantity;
+                record.updated_at = request.updated_at;
+            });
+            break;
         }
         
-        order.updated_at = fill.timestamp;
+        case Command::Kind::UPDATE: {
+            Slot* slot = find_live(request.id);
+            if (!slot) break;
+            
+            change(*slot, [&request](OrderRecord& record) { record = request; });
+            break;
+        }
         
-        if (order_callback_) {
-            order_callback_(order);
+        case Command::Kind::FILL: {
+            const FillRecord& fill = command.fill;
+            if (journal_) {
+                journal_strings();
+                journal_->append_fill(fill);
+            }
+            
+            Slot* slot = find_live(fill.order_id);
+            if (slot) {
+                change(*slot, [&fill](OrderRecord& order) {
+                    order.filled_quantity += fill.quantity;
+                    order.remaining_quantity = order.quantity - order.filled_quantity;
+                    
+                    double total_value = order.avg_fill_price * (order.filled_quantity - fill.quantity) +
+                                        fill.price * fill.quantity;
+                    order.avg_fill_price = total_value / order.filled_quantity;
+                    
+                    if (order.remaining_quantity <= 0.0) {
+                        order.status = OrderStatus::FILLED;
+                        order.filled_at = fill.timestamp;
+                    } else {
+                        order.status = OrderStatus::PARTIALLY_FILLED;
+                    }
+                    
+                    order.updated_at = fill.timestamp;
+                });
+            }
+            
+            if (fill_callback_) {
+                fill_callback_(fill);
+            }
+            if (notifications_) {
+                Notification notification;
+                notification.kind = Notification::Kind::FILL;
+                notification.fill = fill;
+                publish(notification);
+            }
+            break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Asynchronous subscribers
+
+void OrderManager::subscribe(OrderUpdateCallback on_update, FillCallback on_fill) {
+    if (!notifications_) {
+        notifications_ = std::make_unique<utils::BroadcastRing<Notification>>(
+            config_.notify_capacity, config_.max_subscribers);
+    }
+    
+    auto subscriber = std::make_unique<Subscriber>();
+    subscriber->on_update = std::move(on_update);
+    subscriber->on_fill = std::move(on_fill);
+    subscriber->consumer = notifications_->add_consumer();
+    subscriber->thread = std::thread(&OrderManager::consume, this, std::ref(*subscriber));
+    subscribers_.push_back(std::move(subscriber));
+}
+
+void OrderManager::publish(const Notification& notification) {
+    auto start = std::chrono::steady_clock::now();
+    
+    if (!notifications_->try_publish(notification)) {
+        if (config_.notify_backpressure == NotifyBackpressure::DROP) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        } else {
+            while (!notifications_->try_publish(notification)) {
+                std::this_thread::yield();
+            }
         }
     }
     
-    if (fill_callback_) {
-        fill_callback_(fill);
+    auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    publish_ns_total_.store(publish_ns_total_.load(std::memory_order_relaxed) + elapsed,
+                            std::memory_order_relaxed);
+    if (elapsed > publish_ns_max_.load(std::memory_order_relaxed)) {
+        publish_ns_max_.store(elapsed, std::memory_order_relaxed);
+    }
+}
+
+void OrderManager::consume(Subscriber& subscriber) {
+    auto& ring = *notifications_;
+    Notification notification;
+    
+    while (true) {
+        // Read the flag first: once it is clear, an empty ring stays empty
+        bool stopping = !notifying_.load(std::memory_order_acquire);
+        
+        if (!ring.poll(subscriber.consumer, notification)) {
+            if (stopping) break;
+            std::this_thread::yield();
+            continue;
+        }
+        
+        uint64_t lag = ring.published() - ring.consumed(subscriber.consumer);
+        if (lag > subscriber.max_lag.load(std::memory_order_relaxed)) {
+            subscriber.max_lag.store(lag, std::memory_order_relaxed);
+        }
+        
+        if (notification.kind == Notification::Kind::ORDER) {
+            if (subscriber.on_update) subscriber.on_update(notification.order);
+        } else if (subscriber.on_fill) {
+            subscriber.on_fill(notification.fill);
+        }
+    }
+}
+
+void OrderManager::stop_subscribers() {
+    // Consumers deliver what is still queued before they exit
+    notifying_.store(false, std::memory_order_release);
+    for (auto& subscriber : subscribers_) {
+        subscriber->thread.join();
     }
+    subscribers_.clear();
 }
 
-const Order* OrderManager::get_order(OrderID order_id) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+NotificationStats OrderManager::notification_stats() const {
+    NotificationStats stats;
+    if (!notifications_) return stats;
+    
+    stats.published = notifications_->published();
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.max_publish_latency = publish_ns_max_.load(std::memory_order_relaxed);
     
-    auto it = orders_.find(order_id);
-    return (it != orders_.end()) ? &it->second : nullptr;
+    uint64_t attempts = stats.published + stats.dropped;
+    if (attempts > 0) {
+        stats.avg_publish_latency =
+            static_cast<double>(publish_ns_total_.load(std::memory_order_relaxed)) / attempts;
+    }
+    
+    for (const auto& subscriber : subscribers_) {
+        // Cursor before head, so the difference cannot go negative
+        uint64_t consumed = notifications_->consumed(subscriber->consumer);
+        stats.lag = std::max(stats.lag, notifications_->published() - consumed);
+        stats.max_lag = std::max(stats.max_lag, subscriber->max_lag.load(std::memory_order_relaxed));
+    }
+    return stats;
 }
 
-std::vector<Order> OrderManager::get_open_orders() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+// ---------------------------------------------------------------------------
+// Journal
+
+void OrderManager::journal_strings() {
+    uint32_t count = num_strings_.load(std::memory_order_acquire);
+    if (count == journaled_strings_) return;
     
-    std::vector<Order> open_orders;
-    for (const auto& [_, order] : orders_) {
-        if (order.is_open()) {
-            open_orders.push_back(order);
+    std::lock_guard<std::mutex> lock(strings_mutex_);
+    for (; journaled_strings_ < count; ++journaled_strings_) {
+        journal_->append_string(journaled_strings_, strings_.get(journaled_strings_));
+    }
+}
+
+void OrderManager::recover() {
+    // A local class shares the member function's access to private state
+    struct Replay {
+        OrderManager& manager;
+        OrderID max_id;
+        
+        void on_string(StringHandle handle, std::string_view str) {
+            if (manager.strings_.intern(str) != handle) {
+                throw std::runtime_error("Order journal string table is inconsistent");
+            }
+        }
+        
+        void on_order(const OrderRecord& order) {
+            Slot& slot = manager.allocate(order.id);
+            if (slot.version.load(std::memory_order_relaxed) == 0) {
+                manager.num_orders_.fetch_add(1, std::memory_order_relaxed);
+            }
+            manager.change(slot, [&order](OrderRecord& record) { record = order; });
+            max_id = std::max(max_id, order.id);
         }
+        
+        void on_fill(const FillRecord&) {}
+    };
+    
+    Replay replay{*this, 0};
+    recovering_ = true;
+    journal_->replay(replay);
+    recovering_ = false;
+    
+    uint32_t count = static_cast<uint32_t>(strings_.size());
+    num_strings_.store(count, std::memory_order_release);
+    journaled_strings_ = count;
+    id_cursor_.store(replay.max_id + 1, std::memory_order_release);
+}
+
+void OrderManager::sync_journal() {
+    if (journal_) {
+        journal_->sync();
     }
-    return open_orders;
 }
 
-std::vector<Order> OrderManager::get_orders_by_symbol(const Symbol& symbol) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+// ---------------------------------------------------------------------------
+// Indexes
+
+void OrderManager::index(Slot& slot) {
+    const OrderRecord& record = slot.record;
+    
+    slot.open_pos = static_cast<uint32_t>(open_ids_.size());
+    open_ids_.push_back(record.id);
+    
+    auto& by_symbol = index_list(by_symbol_, record.symbol);
+    slot.symbol_pos = static_cast<uint32_t>(by_symbol.size());
+    by_symbol.push_back(record.id);
     
-    std::vector<Order> symbol_orders;
-    for (const auto& [_, order] : orders_) {
-        if (order.symbol == symbol) {
-            symbol_orders.push_back(order);
+    auto& by_strategy = index_list(by_strategy_, record.strategy_id);
+    slot.strategy_pos = static_cast<uint32_t>(by_strategy.size());
+    by_strategy.push_back(record.id);
+}
+
+void OrderManager::unindex(Slot& slot, StringHandle symbol, StringHandle strategy) {
+    erase_at(open_ids_, slot.open_pos, &Slot::open_pos);
+    erase_at(by_symbol_[symbol], slot.symbol_pos, &Slot::symbol_pos);
+    erase_at(by_strategy_[strategy], slot.strategy_pos, &Slot::strategy_pos);
+}
+
+std::vector<OrderID>& OrderManager::index_list(std::vector<std::vector<OrderID>>& lists,
+                                               StringHandle handle) {
+    if (handle >= lists.size()) {
+        lists.resize(handle + 1);
+    }
+    return lists[handle];
+}
+
+void OrderManager::erase_at(std::vector<OrderID>& ids, uint32_t pos, uint32_t Slot::*field) {
+    // Swap-remove; the order moved into the hole records its new position
+    OrderID moved = ids.back();
+    ids[pos] = moved;
+    find(moved)->*field = pos;
+    ids.pop_back();
+}
+
+void OrderManager::fill_record(OrderRecord& record, const Order& order,
+                               InternCache& strings) const {
+    record.id = order.id;
+    record.quantity = order.quantity;
+    record.price = order.price;
+    record.stop_price = order.stop_price;
+    record.filled_quantity = order.filled_quantity;
+    record.remaining_quantity = order.remaining_quantity;
+    record.avg_fill_price = order.avg_fill_price;
+    record.created_at = order.created_at;
+    record.submitted_at = order.submitted_at;
+    record.updated_at = order.updated_at;
+    record.filled_at = order.filled_at;
+    record.symbol = strings.intern(order.symbol);
+    record.strategy_id = strings.intern(order.strategy_id);
+    record.exchange_id = strings.intern(order.exchange_id);
+    record.client_order_id.assign(order.client_order_id);
+    record.exchange_order_id.assign(order.exchange_order_id);
+    record.rejection_reason.assign(order.rejection_reason);
+    record.type = order.type;
+    record.side = order.side;
+    record.tif = order.tif;
+    record.status = order.status;
+}
+
+void OrderManager::fill_record(FillRecord& record, const Fill& fill,
+                               InternCache& strings) const {
+    record.id = fill.id;
+    record.order_id = fill.order_id;
+    record.quantity = fill.quantity;
+    record.price = fill.price;
+    record.commission = fill.commission;
+    record.slippage = fill.slippage;
+    record.timestamp = fill.timestamp;
+    record.symbol = strings.intern(fill.symbol);
+    record.exchange_id = strings.intern(fill.exchange_id);
+    record.side = fill.side;
+}
+
+// ---------------------------------------------------------------------------
+// Readers
+
+bool OrderManager::get_order(OrderID order_id, OrderRecord& out) const {
+    const Slot* slot = find(order_id);
+    if (!slot) return false;
+    
+    while (true) {
+        uint32_t before = slot->version.load(std::memory_order_acquire);
+        if (before == 0) return false;
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
         }
+        
+        std::memcpy(&out, &slot->record, sizeof(OrderRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->version.load(std::memory_order_relaxed) == before) return true;
+    }
+}
+
+OrderView OrderManager::get_open_orders() const {
+    return OrderView(*this, open_ids_);
+}
+
+OrderView OrderManager::get_open_orders(const Symbol& symbol) const {
+    StringHandle handle;
+    if (!owner_strings_.find(symbol, handle) || handle >= by_symbol_.size()) {
+        return OrderView(*this, no_orders_);
     }
-    return symbol_orders;
+    return OrderView(*this, by_symbol_[handle]);
+}
+
+OrderView OrderManager::get_open_orders_by_strategy(const StrategyID& strategy_id) const {
+    StringHandle handle;
+    if (!owner_strings_.find(strategy_id, handle) || handle >= by_strategy_.size()) {
+        return OrderView(*this, no_orders_);
+    }
+    return OrderView(*this, by_strategy_[handle]);
+}
+
+size_t OrderManager::num_open_orders() const {
+    return open_count_.load(std::memory_order_relaxed);
+}
+
+size_t OrderManager::num_total_orders() const {
+    return num_orders_.load(std::memory_order_relaxed);
+}
+
+Order OrderManager::to_order(const OrderRecord& record) const {
+    std::lock_guard<std::mutex> lock(strings_mutex_);
+    
+    Order order{};
+    order.id = record.id;
+    order.symbol = strings_.get(record.symbol);
+    order.type = record.type;
+    order.side = record.side;
+    order.quantity = record.quantity;
+    order.price = record.price;
+    order.stop_price = record.stop_price;
+    order.tif = record.tif;
+    order.status = record.status;
+    order.filled_quantity = record.filled_quantity;
+    order.remaining_quantity = record.remaining_quantity;
+    order.avg_fill_price = record.avg_fill_price;
+    order.created_at = record.created_at;
+    order.submitted_at = record.submitted_at;
+    order.updated_at = record.updated_at;
+    order.filled_at = record.filled_at;
+    order.strategy_id = strings_.get(record.strategy_id);
+    order.exchange_id = strings_.get(record.exchange_id);
+    order.client_order_id = std::string(record.client_order_id.view());
+    order.exchange_order_id = std::string(record.exchange_order_id.view());
+    order.rejection_reason = std::string(record.rejection_reason.view());
+    return order;
+}
+
+const std::string& OrderManager::lookup(StringHandle handle) const {
+    // Stored strings never move, so the reference outlives the lock
+    std::lock_guard<std::mutex> lock(strings_mutex_);
+    return strings_.get(handle);
 }
 
 void OrderManager::on_order_update(OrderUpdateCallback callback) {
@@ -137,16 +688,146 @@ void OrderManager::on_fill(FillCallback callback) {
     fill_callback_ = callback;
 }
 
-size_t OrderManager::num_open_orders() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+// ---------------------------------------------------------------------------
+// Helpers
+
+bool OrderManager::InternCache::find(const std::string& str, StringHandle& handle) const {
+    if (str.empty()) {
+        handle = 0;
+        return true;
+    }
     
-    return std::count_if(orders_.begin(), orders_.end(),
-        [](const auto& p) { return p.second.is_open(); });
+    auto it = handles_.find(str);
+    if (it != handles_.end()) {
+        handle = it->second;
+        return true;
+    }
+    
+    std::lock_guard<std::mutex> lock(manager_.strings_mutex_);
+    handle = manager_.strings_.find(str);
+    return handle != 0;
 }
 
-size_t OrderManager::num_total_orders() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return orders_.size();
+StringHandle OrderManager::InternCache::intern(const std::string& str) {
+    if (str.empty()) return 0;
+    
+    auto it = handles_.find(str);
+    if (it != handles_.end()) return it->second;
+    
+    StringHandle handle;
+    {
+        std::lock_guard<std::mutex> lock(manager_.strings_mutex_);
+        handle = manager_.strings_.intern(str);
+        manager_.num_strings_.store(static_cast<uint32_t>(manager_.strings_.size()),
+                                    std::memory_order_release);
+    }
+    handles_.emplace(str, handle);
+    return handle;
+}
+
+OrderID OrderManager::IdBlock::next() {
+    if (next_ == end_) {
+        size_t block = manager_.config_.id_block;
+        next_ = manager_.id_cursor_.fetch_add(block, std::memory_order_acq_rel);
+        end_ = next_ + block;
+    }
+    return next_++;
+}
+
+OrderManager::Producer::Producer(OrderManager& manager)
+    : manager_(manager),
+      queue_(manager.config_.queue_capacity),
+      strings_(manager),
+      ids_(manager) {}
+
+void OrderManager::Producer::push(const Command& command) {
+    while (!queue_.push(command)) {
+        std::this_thread::yield();
+    }
+}
+
+void OrderManager::Producer::push(const Command* commands, size_t count) {
+    while (count > 0) {
+        size_t pushed = queue_.push(commands, count);
+        commands += pushed;
+        count -= pushed;
+        if (count > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+OrderID OrderManager::Producer::submit_order(const Order& order) {
+    Command command{};
+    command.kind = Command::Kind::SUBMIT;
+    manager_.fill_record(command.order, order, strings_);
+    command.order.id = ids_.next();
+    command.order.created_at = TimeUtils::now();
+    push(command);
+    return command.order.id;
+}
+
+void OrderManager::Producer::cancel_order(OrderID order_id) {
+    Command command{};
+    command.kind = Command::Kind::CANCEL;
+    command.order.id = order_id;
+    command.order.updated_at = TimeUtils::now();
+    push(command);
+}
+
+void OrderManager::Producer::modify_order(OrderID order_id, double new_price, double new_quantity) {
+    Command command{};
+    command.kind = Command::Kind::MODIFY;
+    command.order.id = order_id;
+    command.order.price = new_price;
+    command.order.quantity = new_quantity;
+    command.order.updated_at = TimeUtils::now();
+    push(command);
+}
+
+std::vector<OrderID> OrderManager::Producer::submit_orders(const std::vector<Order>& orders) {
+    std::vector<OrderID> ids(orders.size());
+    Timestamp now = TimeUtils::now();
+    
+    batch_.resize(orders.size());
+    for (size_t i = 0; i < orders.size(); ++i) {
+        Command& command = batch_[i];
+        command = Command{};
+        command.kind = Command::Kind::SUBMIT;
+        manager_.fill_record(command.order, orders[i], strings_);
+        command.order.id = ids[i] = ids_.next();
+        command.order.created_at = now;
+    }
+    push(batch_.data(), batch_.size());
+    return ids;
+}
+
+void OrderManager::Producer::cancel_orders(const std::vector<OrderID>& order_ids) {
+    Timestamp now = TimeUtils::now();
+    
+    batch_.resize(order_ids.size());
+    for (size_t i = 0; i < order_ids.size(); ++i) {
+        Command& command = batch_[i];
+        command = Command{};
+        command.kind = Command::Kind::CANCEL;
+        command.order.id = order_ids[i];
+        command.order.updated_at = now;
+    }
+    push(batch_.data(), batch_.size());
+}
+
+void OrderManager::Producer::update_order(const Order& order) {
+    Command command{};
+    command.kind = Command::Kind::UPDATE;
+    manager_.fill_record(command.order, order, strings_);
+    push(command);
+}
+
+void OrderManager::Producer::add_fill(const Fill& fill) {
+    Command command{};
+    command.kind = Command::Kind::FILL;
+    manager_.fill_record(command.fill, fill, strings_);
+    push(command);
 }
 
 } // namespace execution
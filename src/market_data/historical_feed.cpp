@@ -76,11 +76,14 @@ void HistoricalFeed::start() {
         return;
     }
     
+    prime_events();
+    replay_thread_ = std::thread(&HistoricalFeed::replay_events, this);
+}
+
+void HistoricalFeed::prime_events() {
     for (const auto& [symbol, _] : data_files_) {
         read_next_event(symbol);
     }
-    
-    replay_thread_ = std::thread(&HistoricalFeed::replay_events, this);
 }
 
 void HistoricalFeed::stop() {
@@ -166,50 +169,22 @@ bool HistoricalFeed::read_next_event(const Symbol& symbol) {
 }
 
 void HistoricalFeed::replay_events() {
-    auto replay_start = std::chrono::steady_clock::now();
-    Timestamp sim_start_time = current_time_;
+    CallbackSink sink{*this};
+    replay_loop(sink);
+}
+
+void HistoricalFeed::pace(Timestamp sim_start_time,
+                          std::chrono::steady_clock::time_point replay_start) const {
+    Timestamp sim_elapsed = current_time_ - sim_start_time;
+    auto real_elapsed = std::chrono::steady_clock::now() - replay_start;
+    auto real_elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(real_elapsed).count();
     
-    while (running_.load() && !event_queue_.empty()) {
-        auto [timestamp, event_variant] = event_queue_.top();
-        event_queue_.pop();
-        
-        current_time_ = timestamp;
-        
-        if (config_.replay_speed > 0.0) {
-            Timestamp sim_elapsed = current_time_ - sim_start_time;
-            auto real_elapsed = std::chrono::steady_clock::now() - replay_start;
-            auto real_elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(real_elapsed).count();
-            
-            Timestamp target_real_elapsed = sim_elapsed / config_.replay_speed;
-            
-            if (real_elapsed_ns < target_real_elapsed) {
-                std::this_thread::sleep_for(
-                    std::chrono::nanoseconds(target_real_elapsed - real_elapsed_ns)
-                );
-            }
-        }
-        
-        std::visit([this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            
-            if constexpr (std::is_same_v<T, Tick>) {
-                if (tick_callback_) tick_callback_(arg);
-            } else if constexpr (std::is_same_v<T, Bar>) {
-                if (bar_callback_) bar_callback_(arg);
-            } else if constexpr (std::is_same_v<T, OrderBook>) {
-                if (orderbook_callback_) orderbook_callback_(arg);
-            }
-        }, event_variant);
-        
-        if (std::holds_alternative<Bar>(event_variant)) {
-            const Bar& bar = std::get<Bar>(event_variant);
-            read_next_event(bar.symbol);
-        }
-    }
+    Timestamp target_real_elapsed = sim_elapsed / config_.replay_speed;
     
-    if (config_.loop && running_.load()) {
-        seek(start_time_);
-        replay_events();
+    if (real_elapsed_ns < target_real_elapsed) {
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds(target_real_elapsed - real_elapsed_ns)
+        );
     }
 }
 
@@ -0,0 +1,108 @@
+#include "quantflow/portfolio/lot_ledger.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace quantflow {
+namespace portfolio {
+
+namespace {
+// Quantities below this are treated as flat, so float residue from
+// fractional fills does not leave dust lots behind
+constexpr double QUANTITY_EPSILON = 1e-9;
+}
+
+void LotLedger::Ring::push(const Lot& lot) {
+    if (size == lots.size()) {
+        // Unroll into a buffer twice the size, oldest lot first
+        std::vector<Lot> grown(std::max<size_t>(lots.size() * 2, 4));
+        for (uint32_t k = 0; k < size; ++k) {
+            grown[k] = at(head + k);
+        }
+        lots.swap(grown);
+        head = 0;
+    }
+    at(head + size) = lot;
+    ++size;
+}
+
+double LotLedger::apply(SymbolIndex i, double quantity, double price, Timestamp timestamp) {
+    if (i >= rings_.size()) {
+        rings_.resize(i + 1);
+    }
+    Ring& ring = rings_[i];
+
+    double realized = 0.0;
+    double remaining = quantity;
+
+    // Close lots on the other side of the fill
+    while (ring.size > 0 && std::abs(remaining) > QUANTITY_EPSILON) {
+        Lot& lot = (method_ == LotMethod::FIFO) ? ring.at(ring.head) : ring.at(ring.head + ring.size - 1);
+        double side = (lot.quantity > 0.0) ? 1.0 : -1.0;
+        if ((remaining > 0.0) == (side > 0.0)) break;
+
+        double closed = std::min(std::abs(remaining), std::abs(lot.quantity));
+        realized += side * closed * (price - lot.price);
+        lot.quantity -= side * closed;
+        ring.quantity -= side * closed;
+        ring.cost -= side * closed * lot.price;
+        remaining += side * closed;
+
+        if (std::abs(lot.quantity) <= QUANTITY_EPSILON) {
+            // Drop the dust from the totals along with the lot
+            ring.quantity -= lot.quantity;
+            ring.cost -= lot.quantity * lot.price;
+            if (method_ == LotMethod::FIFO) {
+                ring.head = (ring.head + 1) & static_cast<uint32_t>(ring.lots.size() - 1);
+            }
+            --ring.size;
+        }
+    }
+
+    if (std::abs(remaining) > QUANTITY_EPSILON) {
+        ring.push(Lot{remaining, price, timestamp});
+        ring.quantity += remaining;
+        ring.cost += remaining * price;
+    }
+
+    if (ring.size == 0) {
+        ring.head = 0;
+        ring.quantity = 0.0;
+        ring.cost = 0.0;
+    }
+    return realized;
+}
+
+double LotLedger::avg_entry_price(SymbolIndex i) const {
+    if (i >= rings_.size() || rings_[i].size == 0) return 0.0;
+    return rings_[i].cost / rings_[i].quantity;
+}
+
+void LotLedger::save_state(utils::BinaryWriter& out) const {
+    out.write(method_);
+    out.write<uint64_t>(rings_.size());
+    for (const Ring& ring : rings_) {
+        out.write(ring.quantity);
+        out.write(ring.cost);
+        out.write<uint64_t>(ring.size);
+        for (uint32_t k = 0; k < ring.size; ++k) {
+            out.write(ring.at(ring.head + k));
+        }
+    }
+}
+
+void LotLedger::load_state(utils::BinaryReader& in) {
+    in.read(method_);
+    rings_.clear();
+    rings_.resize(in.read<uint64_t>());
+    for (Ring& ring : rings_) {
+        in.read(ring.quantity);
+        in.read(ring.cost);
+        uint64_t num_lots = in.read<uint64_t>();
+        for (uint64_t k = 0; k < num_lots; ++k) {
+            ring.push(in.read<Lot>());
+        }
+    }
+}
+
+} // namespace portfolio
+} // namespace quantflow
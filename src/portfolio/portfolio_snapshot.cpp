@@ -0,0 +1,93 @@
+#include "quantflow/portfolio/portfolio_snapshot.hpp"
+#include <algorithm>
+
+namespace quantflow {
+namespace portfolio {
+
+SnapshotPublisher::SnapshotPublisher(size_t max_symbols)
+    : max_symbols_(max_symbols),
+      current_(0),
+      version_(0),
+      generation_(0),
+      num_names_(0) {
+    for (auto& slot : slots_) {
+        slot.positions.resize(max_symbols);
+    }
+}
+
+void SnapshotPublisher::publish(const PositionBook& book, double cash, double equity,
+                                Timestamp timestamp) {
+    if (names_.empty() || book.generation() != generation_) {
+        names_.push_back(std::make_unique<Symbol[]>(max_symbols_));
+        generation_ = book.generation();
+        num_names_ = 0;
+    }
+
+    // Names are written once, ahead of the release that publishes them
+    Symbol* names = names_.back().get();
+    for (size_t covered = std::min(book.size(), max_symbols_); num_names_ < covered; ++num_names_) {
+        names[num_names_] = book.symbol(static_cast<SymbolIndex>(num_names_));
+    }
+
+    uint32_t next = 1 - current_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[next];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    uint64_t version = version_.load(std::memory_order_relaxed) + 1;
+    slot.version = version;
+    slot.generation = generation_;
+    slot.names = names;
+    slot.timestamp = timestamp;
+    slot.cash = cash;
+    slot.equity = equity;
+
+    size_t n = 0;
+    bool truncated = false;
+    book.for_each_open([&](SymbolIndex i) {
+        if (i >= max_symbols_) {
+            truncated = true;
+            return;
+        }
+        slot.positions[n++] = PositionSnapshot{i, book.quantity(i), book.avg_entry_price(i),
+                                               book.current_price(i), book.realized_pnl(i),
+                                               book.total_commission(i)};
+    });
+    slot.truncated = truncated;
+    slot.num_positions = n;
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    current_.store(next, std::memory_order_release);
+    version_.store(version, std::memory_order_release);
+}
+
+bool SnapshotPublisher::read(PortfolioSnapshot& snapshot) const {
+    if (version_.load(std::memory_order_acquire) == 0) return false;
+
+    for (;;) {
+        const Slot& slot = slots_[current_.load(std::memory_order_acquire)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence & 1) continue;
+
+        snapshot.version = slot.version;
+        snapshot.generation = slot.generation;
+        snapshot.names = slot.names;
+        snapshot.timestamp = slot.timestamp;
+        snapshot.cash = slot.cash;
+        snapshot.equity = slot.equity;
+        snapshot.truncated = slot.truncated;
+
+        // A torn count is discarded below, but must not overrun meanwhile
+        size_t n = std::min(slot.num_positions, max_symbols_);
+        snapshot.positions.assign(slot.positions.begin(), slot.positions.begin() + n);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            return true;
+        }
+    }
+}
+
+} // namespace portfolio
+} // namespace quantflow
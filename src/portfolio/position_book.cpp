@@ -0,0 +1,215 @@
+#include "quantflow/portfolio/position_book.hpp"
+#include <algorithm>
+#include <atomic>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace quantflow {
+namespace portfolio {
+
+uint64_t PositionBook::next_generation() {
+    static std::atomic<uint64_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+SymbolIndex PositionBook::index(const Symbol& symbol) {
+    auto it = indices_.find(symbol);
+    if (it != indices_.end()) return it->second;
+
+    auto i = static_cast<SymbolIndex>(symbols_.size());
+    indices_.emplace(symbol, i);
+    symbols_.push_back(symbol);
+
+    quantity_.push_back(0.0);
+    avg_entry_price_.push_back(0.0);
+    current_price_.push_back(0.0);
+    unrealized_pnl_.push_back(0.0);
+    realized_pnl_.push_back(0.0);
+    total_commission_.push_back(0.0);
+    opened_at_.push_back(0);
+    last_updated_.push_back(0);
+
+    if ((i & 63) == 0) {
+        open_bits_.push_back(0);
+    }
+
+    is_dirty_.push_back(0);
+    if (view_) {
+        Position& view = (*view_)[symbol];
+        view = Position{};
+        view.symbol = symbol;
+        views_.push_back(&view);
+    }
+    return i;
+}
+
+bool PositionBook::find(const Symbol& symbol, SymbolIndex& index) const {
+    auto it = indices_.find(symbol);
+    if (it == indices_.end()) return false;
+    index = it->second;
+    return true;
+}
+
+void PositionBook::set_quantity(SymbolIndex i, double quantity, Timestamp now) {
+    uint64_t bit = uint64_t{1} << (i & 63);
+    bool was_open = open_bits_[i >> 6] & bit;
+    bool now_open = quantity != 0;
+    if (now_open && (!was_open || (quantity > 0) != (quantity_[i] > 0))) {
+        opened_at_[i] = now;
+    }
+    if (was_open != now_open) {
+        open_bits_[i >> 6] ^= bit;
+        num_open_ += now_open ? 1 : -1;
+    }
+
+    market_value_ += (quantity - quantity_[i]) * current_price_[i];
+    quantity_[i] = quantity;
+    last_updated_[i] = now;
+    touch(i);
+}
+
+void PositionBook::set_avg_entry_price(SymbolIndex i, double price) {
+    avg_entry_price_[i] = price;
+    touch(i);
+}
+
+void PositionBook::add_realized_pnl(SymbolIndex i, double pnl) {
+    realized_pnl_[i] += pnl;
+    touch(i);
+}
+
+void PositionBook::add_commission(SymbolIndex i, double commission) {
+    total_commission_[i] += commission;
+    touch(i);
+}
+
+void PositionBook::mark(SymbolIndex i, double price, Timestamp now) {
+    market_value_ += quantity_[i] * (price - current_price_[i]);
+    current_price_[i] = price;
+    unrealized_pnl_[i] = (price - avg_entry_price_[i]) * quantity_[i];
+    last_updated_[i] = now;
+    touch(i);
+}
+
+void PositionBook::mark_all(const double* prices, Timestamp now) {
+    const size_t n = symbols_.size();
+    const double* quantity = quantity_.data();
+    const double* avg = avg_entry_price_.data();
+    double* current = current_price_.data();
+    double* unrealized = unrealized_pnl_.data();
+
+    size_t i = 0;
+    double total = 0.0;
+
+#ifdef __AVX2__
+    __m256d sum = _mm256_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(prices + i);
+        __m256d q = _mm256_loadu_pd(quantity + i);
+        __m256d a = _mm256_loadu_pd(avg + i);
+        _mm256_storeu_pd(current + i, p);
+        _mm256_storeu_pd(unrealized + i, _mm256_mul_pd(_mm256_sub_pd(p, a), q));
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(q, p));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+
+    for (; i < n; ++i) {
+        current[i] = prices[i];
+        unrealized[i] = (prices[i] - avg[i]) * quantity[i];
+        total += quantity[i] * prices[i];
+    }
+
+    // A full pass is also an exact resync
+    market_value_ = total;
+    std::fill(last_updated_.begin(), last_updated_.end(), now);
+
+    if (view_) {
+        for (SymbolIndex j = 0; j < n; ++j) {
+            touch(j);
+        }
+    }
+}
+
+void PositionBook::resync() {
+    double total = 0.0;
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        total += quantity_[i] * current_price_[i];
+    }
+    market_value_ = total;
+}
+
+Position PositionBook::position(SymbolIndex i) const {
+    Position pos{};
+    pos.symbol = symbols_[i];
+    pos.quantity = quantity_[i];
+    pos.avg_entry_price = avg_entry_price_[i];
+    pos.current_price = current_price_[i];
+    pos.realized_pnl = realized_pnl_[i];
+    pos.unrealized_pnl = unrealized_pnl_[i];
+    pos.total_pnl = realized_pnl_[i] + unrealized_pnl_[i];
+    pos.total_commission = total_commission_[i];
+    pos.opened_at = opened_at_[i];
+    pos.last_updated = last_updated_[i];
+    return pos;
+}
+
+void PositionBook::restore(const Position& position) {
+    SymbolIndex i = index(position.symbol);
+    set_quantity(i, position.quantity, position.last_updated);
+    avg_entry_price_[i] = position.avg_entry_price;
+    mark(i, position.current_price, position.last_updated);
+    unrealized_pnl_[i] = position.unrealized_pnl;
+    realized_pnl_[i] = position.realized_pnl;
+    total_commission_[i] = position.total_commission;
+    opened_at_[i] = position.opened_at;
+    last_updated_[i] = position.last_updated;
+}
+
+void PositionBook::sync_view() {
+    for (SymbolIndex i : dirty_) {
+        Position& view = *views_[i];
+        view.quantity = quantity_[i];
+        view.avg_entry_price = avg_entry_price_[i];
+        view.current_price = current_price_[i];
+        view.realized_pnl = realized_pnl_[i];
+        view.unrealized_pnl = unrealized_pnl_[i];
+        view.total_pnl = realized_pnl_[i] + unrealized_pnl_[i];
+        view.total_commission = total_commission_[i];
+        view.opened_at = opened_at_[i];
+        view.last_updated = last_updated_[i];
+        is_dirty_[i] = 0;
+    }
+    dirty_.clear();
+}
+
+void PositionBook::clear() {
+    indices_.clear();
+    symbols_.clear();
+    quantity_.clear();
+    avg_entry_price_.clear();
+    current_price_.clear();
+    unrealized_pnl_.clear();
+    realized_pnl_.clear();
+    total_commission_.clear();
+    opened_at_.clear();
+    last_updated_.clear();
+    open_bits_.clear();
+    market_value_ = 0.0;
+    num_open_ = 0;
+    generation_ = next_generation();
+
+    views_.clear();
+    dirty_.clear();
+    is_dirty_.clear();
+    if (view_) {
+        view_->clear();
+    }
+}
+
+} // namespace portfolio
+} // namespace quantflow
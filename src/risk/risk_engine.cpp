@@ -0,0 +1,258 @@
+#include "quantflow/risk/risk_engine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#endif
+
+namespace quantflow {
+namespace risk {
+
+namespace {
+
+constexpr size_t LANES = 4;
+constexpr double PI = 3.14159265358979323846;
+
+size_t round_up(size_t n, size_t multiple) {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+// row[j] += xi * x[j] - yi * y[j] for j in [begin, end), both multiples of LANES
+void update_row(double* row, const double* x, const double* y,
+                double xi, double yi, size_t begin, size_t end) {
+    size_t j = begin;
+#if defined(__AVX2__) && defined(__FMA__)
+    __m256d vxi = _mm256_set1_pd(xi);
+    __m256d vyi = _mm256_set1_pd(yi);
+    for (; j < end; j += LANES) {
+        __m256d r = _mm256_loadu_pd(row + j);
+        r = _mm256_fmadd_pd(vxi, _mm256_loadu_pd(x + j), r);
+        r = _mm256_fnmadd_pd(vyi, _mm256_loadu_pd(y + j), r);
+        _mm256_storeu_pd(row + j, r);
+    }
+#endif
+    for (; j < end; ++j) {
+        row[j] += xi * x[j] - yi * y[j];
+    }
+}
+
+// Acklam's rational approximation of the standard normal quantile
+double inverse_normal(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02,
+                               -2.759285104469687e+02, 1.383577518672690e+02,
+                               -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02,
+                               -1.556989798598866e+02, 6.680131188771972e+01,
+                               -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01,
+                               -2.400758277161838e+00, -2.549732539343734e+00,
+                               4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01,
+                               2.445134137142996e+00, 3.754408661907416e+00};
+
+    const double low = 0.02425;
+    if (p < low) {
+        double q = std::sqrt(-2.0 * std::log(p));
+        return (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+               ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    if (p > 1.0 - low) {
+        double q = std::sqrt(-2.0 * std::log(1.0 - p));
+        return -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+} // namespace
+
+RiskEngine::RiskEngine(const std::vector<Symbol>& universe, const RiskEngineConfig& config)
+    : config_(config),
+      symbols_(universe),
+      index_(universe),
+      stride_(round_up(std::max<size_t>(universe.size(), 1), LANES)),
+      head_(0),
+      count_(0),
+      updates_since_resync_(0),
+      primed_(false) {
+    if (config.window < 2) {
+        throw std::invalid_argument("RiskEngine window must hold at least two periods");
+    }
+    if (config.confidence <= 0.0 || config.confidence >= 1.0) {
+        throw std::invalid_argument("RiskEngine confidence must be in (0, 1)");
+    }
+    config_.block_size = round_up(std::max<size_t>(config.block_size, LANES), LANES);
+
+    size_t n = symbols_.size();
+    cross_.assign(n * stride_, 0.0);
+    sum_.assign(stride_, 0.0);
+    window_.assign(config.window * stride_, 0.0);
+    zeros_.assign(stride_, 0.0);
+    last_.assign(n, 0.0);
+    pending_.assign(n, 0.0);
+    returns_.assign(stride_, 0.0);
+}
+
+void RiskEngine::rank2_update(const double* add, const double* remove) {
+    const size_t n = symbols_.size();
+    const size_t block = config_.block_size;
+
+    // One block of columns at a time, so add/remove[jb, jb + block) stay
+    // cached while every row above the diagonal sweeps across them
+    for (size_t jb = 0; jb < stride_; jb += block) {
+        size_t j_end = std::min(jb + block, stride_);
+        size_t i_end = std::min(j_end, n);
+
+        for (size_t i = 0; i < i_end; ++i) {
+            // Starting at the vector holding the diagonal touches a few
+            // lower-triangle cells, which are never read
+            size_t j_begin = std::max(jb, i & ~(LANES - 1));
+            update_row(&cross_[i * stride_], add, remove, add[i], remove[i], j_begin, j_end);
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        sum_[i] += add[i] - remove[i];
+    }
+}
+
+void RiskEngine::update(const double* returns) {
+    std::copy(returns, returns + symbols_.size(), returns_.begin());
+    push_returns();
+}
+
+void RiskEngine::push_returns() {
+    double* row = &window_[head_ * stride_];
+    rank2_update(returns_.data(), (count_ == config_.window) ? row : zeros_.data());
+    std::copy(returns_.begin(), returns_.end(), row);
+
+    head_ = (head_ + 1) % config_.window;
+    count_ = std::min(count_ + 1, config_.window);
+
+    if (++updates_since_resync_ >= config_.window) {
+        resync();
+    }
+}
+
+void RiskEngine::close_period() {
+    if (!primed_) {
+        last_ = pending_;
+        primed_ = true;
+        return;
+    }
+
+    // Built in place in returns_, so a period allocates nothing
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        returns_[i] = (last_[i] > 0.0 && pending_[i] > 0.0) ? pending_[i] / last_[i] - 1.0 : 0.0;
+    }
+    last_ = pending_;
+    push_returns();
+}
+
+void RiskEngine::resync() {
+    updates_since_resync_ = 0;
+    std::fill(cross_.begin(), cross_.end(), 0.0);
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+
+    for (size_t t = 0; t < count_; ++t) {
+        rank2_update(&window_[t * stride_], zeros_.data());
+    }
+}
+
+double RiskEngine::mean(size_t i) const {
+    return (count_ > 0) ? sum_[i] / count_ : 0.0;
+}
+
+double RiskEngine::covariance(size_t i, size_t j) const {
+    if (count_ < 2) return 0.0;
+    if (i > j) std::swap(i, j);
+
+    double n = static_cast<double>(count_);
+    return (cross_[i * stride_ + j] - sum_[i] * sum_[j] / n) / (n - 1.0);
+}
+
+double RiskEngine::portfolio_variance(const double* exposures) const {
+    const size_t n = symbols_.size();
+
+    // e'Ce from the upper triangle: diagonal once, off-diagonal twice
+    double quad = 0.0;
+    double weighted_sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double ei = exposures[i];
+        if (ei == 0.0) continue;
+
+        const double* row = &cross_[i * stride_];
+        double off = 0.0;
+        for (size_t j = i + 1; j < n; ++j) {
+            off += row[j] * exposures[j];
+        }
+        quad += ei * (row[i] * ei + 2.0 * off);
+        weighted_sum += ei * sum_[i];
+    }
+
+    double count = static_cast<double>(count_);
+    return std::max(0.0, (quad - weighted_sum * weighted_sum / count) / (count - 1.0));
+}
+
+RiskReport RiskEngine::report(const double* exposures) const {
+    RiskReport report;
+    report.observations = count_;
+    if (count_ < 2) return report;
+
+    const size_t n = symbols_.size();
+    const double tail = 1.0 - config_.confidence;
+
+    // Parametric, normal P&L
+    double mu = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        mu += exposures[i] * mean(i);
+    }
+    double sigma = std::sqrt(portfolio_variance(exposures));
+    double z = inverse_normal(config_.confidence);
+    double density = std::exp(-0.5 * z * z) / std::sqrt(2.0 * PI);
+
+    report.volatility = sigma;
+    report.parametric_var = z * sigma - mu;
+    report.parametric_es = sigma * density / tail - mu;
+
+    // Historical: revalue the exposures under each stored period
+    std::vector<double> pnl(count_);
+    for (size_t t = 0; t < count_; ++t) {
+        const double* row = &window_[t * stride_];
+        double value = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            value += exposures[i] * row[i];
+        }
+        pnl[t] = value;
+    }
+
+    size_t worst = std::max<size_t>(1, static_cast<size_t>(std::ceil(tail * count_)));
+    std::partial_sort(pnl.begin(), pnl.begin() + worst, pnl.end());
+
+    double tail_sum = 0.0;
+    for (size_t k = 0; k < worst; ++k) {
+        tail_sum += pnl[k];
+    }
+    report.historical_var = -pnl[worst - 1];
+    report.historical_es = -tail_sum / worst;
+    return report;
+}
+
+RiskReport RiskEngine::report(const PortfolioState& portfolio) const {
+    std::vector<double> exposures(symbols_.size(), 0.0);
+    for (const auto& [symbol, pos] : portfolio.positions) {
+        size_t i;
+        if (find(symbol, i)) {
+            exposures[i] = pos.market_value();
+        }
+    }
+    return report(exposures.data());
+}
+
+} // namespace risk
+} // namespace quantflow
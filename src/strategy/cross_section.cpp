@@ -0,0 +1,228 @@
+#include "quantflow/strategy/cross_section.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace quantflow {
+namespace strategy {
+
+namespace {
+
+constexpr double MISSING = std::numeric_limits<double>::quiet_NaN();
+
+template<typename Entry>
+bool by_value(const Entry& a, const Entry& b) {
+    return a.value < b.value;
+}
+
+} // namespace
+
+CrossSection::CrossSection(const std::vector<Symbol>& universe, const std::vector<std::string>& factors,
+                           const CrossSectionConfig& config)
+    : config_(config),
+      symbols_(universe),
+      index_(universe),
+      factors_(factors),
+      values_(universe.size() * factors.size(), MISSING),
+      ranks_(universe.size() * factors.size(), MISSING),
+      zscores_(universe.size() * factors.size(), MISSING),
+      buckets_(universe.size() * factors.size(), -1),
+      counts_(factors.size(), 0),
+      order_(universe.size() * factors.size()),
+      timestamp_(0) {
+    if (config.num_quantiles == 0) {
+        throw std::invalid_argument("CrossSection needs at least one quantile");
+    }
+    if (config.threads > 1 && universe.size() >= config.split_threshold && factors.size() < config.threads) {
+        pool_ = std::make_unique<utils::ThreadPool>(config.threads);
+        merge_.resize(universe.size());
+        chunk_count_.resize(config.threads);
+        chunk_offset_.resize(config.threads + 1);
+        chunk_sum_.resize(config.threads);
+        chunk_squares_.resize(config.threads);
+    } else if (config.threads > 1 && factors.size() > 1) {
+        pool_ = std::make_unique<utils::ThreadPool>(std::min(config.threads, factors.size()));
+    }
+}
+
+bool CrossSection::split_factors() const {
+    return !merge_.empty();
+}
+
+size_t CrossSection::factor(const std::string& name) const {
+    auto it = std::find(factors_.begin(), factors_.end(), name);
+    if (it == factors_.end()) {
+        throw std::invalid_argument("Unknown factor: " + name);
+    }
+    return static_cast<size_t>(it - factors_.begin());
+}
+
+void CrossSection::clear(size_t f) {
+    std::fill_n(&values_[f * stride()], stride(), MISSING);
+}
+
+void CrossSection::compute(Timestamp timestamp) {
+    timestamp_ = timestamp;
+    if (split_factors()) {
+        for (size_t f = 0; f < factors_.size(); ++f) {
+            compute_factor_split(f);
+        }
+    } else if (pool_) {
+        pool_->parallel_for(factors_.size(), [this](size_t f) { compute_factor(f); });
+    } else {
+        for (size_t f = 0; f < factors_.size(); ++f) {
+            compute_factor(f);
+        }
+    }
+}
+
+void CrossSection::compute_factor(size_t f) {
+    const size_t n = stride();
+    const double* value = &values_[f * n];
+    double* rank = &ranks_[f * n];
+    double* zscore = &zscores_[f * n];
+    int32_t* bucket = &buckets_[f * n];
+    Entry* order = &order_[f * n];
+
+    size_t m = 0;
+    double sum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        if (std::isnan(value[i])) {
+            rank[i] = MISSING;
+            zscore[i] = MISSING;
+            bucket[i] = -1;
+        } else {
+            order[m++] = Entry{value[i], static_cast<uint32_t>(i)};
+            sum += value[i];
+        }
+    }
+    counts_[f] = m;
+    if (m == 0) return;
+
+    double mean = sum / m;
+    double squares = 0.0;
+    for (size_t k = 0; k < m; ++k) {
+        double d = order[k].value - mean;
+        squares += d * d;
+    }
+    double stddev = (m > 1) ? std::sqrt(squares / (m - 1)) : 0.0;
+    double inv_stddev = (stddev > 0.0) ? 1.0 / stddev : 0.0;
+    for (size_t k = 0; k < m; ++k) {
+        zscore[order[k].symbol] = (order[k].value - mean) * inv_stddev;
+    }
+
+    std::sort(order, order + m, by_value<Entry>);
+    assign_ranks(f, order, m);
+}
+
+void CrossSection::compute_factor_split(size_t f) {
+    const size_t n = stride();
+    const size_t chunks = pool_->size();
+    const double* value = &values_[f * n];
+    double* rank = &ranks_[f * n];
+    double* zscore = &zscores_[f * n];
+    int32_t* bucket = &buckets_[f * n];
+    Entry* order = &order_[f * n];
+    Entry* scratch = merge_.data();
+    auto chunk_begin = [n, chunks](size_t c) { return c * n / chunks; };
+
+    // Each range gathers its present values to the front of its own slice
+    pool_->parallel_for(chunks, [&](size_t c) {
+        size_t begin = chunk_begin(c);
+        size_t k = begin;
+        double sum = 0.0;
+        for (size_t i = begin; i < chunk_begin(c + 1); ++i) {
+            if (std::isnan(value[i])) {
+                rank[i] = MISSING;
+                zscore[i] = MISSING;
+                bucket[i] = -1;
+            } else {
+                order[k++] = Entry{value[i], static_cast<uint32_t>(i)};
+                sum += value[i];
+            }
+        }
+        chunk_count_[c] = k - begin;
+        chunk_sum_[c] = sum;
+    });
+
+    size_t m = 0;
+    double sum = 0.0;
+    for (size_t c = 0; c < chunks; ++c) {
+        chunk_offset_[c] = m;
+        m += chunk_count_[c];
+        sum += chunk_sum_[c];
+    }
+    chunk_offset_[chunks] = m;
+    counts_[f] = m;
+    if (m == 0) return;
+    double mean = sum / m;
+
+    // Packed into scratch, each range sorted where it lands
+    pool_->parallel_for(chunks, [&](size_t c) {
+        const Entry* from = order + chunk_begin(c);
+        Entry* to = scratch + chunk_offset_[c];
+        double squares = 0.0;
+        for (size_t k = 0; k < chunk_count_[c]; ++k) {
+            double d = from[k].value - mean;
+            squares += d * d;
+            to[k] = from[k];
+        }
+        chunk_squares_[c] = squares;
+        std::sort(to, to + chunk_count_[c], by_value<Entry>);
+    });
+
+    double squares = 0.0;
+    for (size_t c = 0; c < chunks; ++c) {
+        squares += chunk_squares_[c];
+    }
+    double stddev = (m > 1) ? std::sqrt(squares / (m - 1)) : 0.0;
+    double inv_stddev = (stddev > 0.0) ? 1.0 / stddev : 0.0;
+
+    pool_->parallel_for(chunks, [&](size_t c) {
+        const Entry* entries = scratch + chunk_offset_[c];
+        for (size_t k = 0; k < chunk_count_[c]; ++k) {
+            zscore[entries[k].symbol] = (entries[k].value - mean) * inv_stddev;
+        }
+    });
+
+    // Sorted runs merge pairwise, alternating between the two buffers
+    Entry* from = scratch;
+    Entry* to = order;
+    for (size_t width = 1; width < chunks; width *= 2) {
+        pool_->parallel_for((chunks + 2 * width - 1) / (2 * width), [&](size_t p) {
+            size_t a = p * 2 * width;
+            size_t b = std::min(a + width, chunks);
+            size_t e = std::min(a + 2 * width, chunks);
+            std::merge(from + chunk_offset_[a], from + chunk_offset_[b],
+                       from + chunk_offset_[b], from + chunk_offset_[e],
+                       to + chunk_offset_[a], by_value<Entry>);
+        });
+        std::swap(from, to);
+    }
+    assign_ranks(f, from, m);
+}
+
+void CrossSection::assign_ranks(size_t f, const Entry* order, size_t m) {
+    double* rank = &ranks_[f * stride()];
+    int32_t* bucket = &buckets_[f * stride()];
+    const double quantiles = static_cast<double>(config_.num_quantiles);
+    for (size_t k = 0; k < m;) {
+        size_t last = k;
+        while (last + 1 < m && order[last + 1].value == order[k].value) {
+            ++last;
+        }
+
+        // Tied values share the mean of their positions, and so a bucket
+        double shared = 0.5 * static_cast<double>(k + last);
+        auto shared_bucket = static_cast<int32_t>(shared * quantiles / m);
+        for (size_t t = k; t <= last; ++t) {
+            rank[order[t].symbol] = shared;
+            bucket[order[t].symbol] = shared_bucket;
+        }
+        k = last + 1;
+    }
+}
+
+} // namespace strategy
+} // namespace quantflow
@@ -0,0 +1,122 @@
+#include "quantflow/strategy/rebalance.hpp"
+#include "quantflow/strategy/strategy_base.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace quantflow {
+namespace strategy {
+
+RebalanceUniverse::RebalanceUniverse(const std::vector<Symbol>& symbols, const RebalanceConfig& config)
+    : config_(config),
+      symbols_(symbols),
+      index_(symbols),
+      prices_(symbols.size(), 0.0),
+      lot_sizes_(symbols.size(), config.lot_size),
+      holdings_(symbols.size(), 0.0),
+      deltas_(symbols.size(), 0.0),
+      book_index_(symbols.size(), NOT_HELD),
+      book_(nullptr),
+      book_generation_(0),
+      book_size_(0) {
+    if (config.lot_size <= 0.0) {
+        throw std::invalid_argument("Rebalance lot size must be positive");
+    }
+}
+
+void RebalanceUniverse::set_lot_size(size_t i, double lot_size) {
+    if (lot_size <= 0.0) {
+        throw std::invalid_argument("Rebalance lot size must be positive");
+    }
+    lot_sizes_[i] = lot_size;
+}
+
+void RebalanceUniverse::load_holdings(const portfolio::PositionBook& book, const double* working) {
+    // A different book, or this one cleared, starts the cache over
+    if (&book != book_ || book.generation() != book_generation_) {
+        std::fill(book_index_.begin(), book_index_.end(), NOT_HELD);
+        book_ = &book;
+        book_generation_ = book.generation();
+        book_size_ = 0;
+    }
+
+    // Within a generation indices never change once handed out, so only
+    // symbols still missing need a lookup, and only when the book has grown
+    if (book.size() != book_size_) {
+        for (size_t i = 0; i < symbols_.size(); ++i) {
+            portfolio::SymbolIndex pos;
+            if (book_index_[i] == NOT_HELD && book.find(symbols_[i], pos)) {
+                book_index_[i] = pos;
+            }
+        }
+        book_size_ = book.size();
+    }
+
+    const double* quantities = book.quantities();
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        holdings_[i] = (book_index_[i] != NOT_HELD) ? quantities[book_index_[i]] : 0.0;
+    }
+    if (working) {
+        for (size_t i = 0; i < symbols_.size(); ++i) {
+            if (book_index_[i] != NOT_HELD) holdings_[i] += working[book_index_[i]];
+        }
+    }
+}
+
+void RebalanceUniverse::plan(const double* weights, double equity, std::vector<OrderRequest>& orders) {
+    const size_t n = symbols_.size();
+    const double threshold = std::max(config_.min_trade_value, config_.min_trade_weight * std::abs(equity));
+    const double* price = prices_.data();
+    const double* held = holdings_.data();
+    const double* lot = lot_sizes_.data();
+    double* delta = deltas_.data();
+
+    // delta = whole lots toward weight * equity / price, zeroed when
+    // unpriced or under the threshold
+    size_t i = 0;
+#ifdef __AVX2__
+    const __m256d vequity = _mm256_set1_pd(equity);
+    const __m256d vthreshold = _mm256_set1_pd(threshold);
+    const __m256d vzero = _mm256_setzero_pd();
+    const __m256d vsign = _mm256_set1_pd(-0.0);
+    for (; i + 4 <= n; i += 4) {
+        __m256d p = _mm256_loadu_pd(price + i);
+        __m256d l = _mm256_loadu_pd(lot + i);
+        __m256d target = _mm256_div_pd(_mm256_mul_pd(_mm256_loadu_pd(weights + i), vequity), p);
+        __m256d lots = _mm256_round_pd(_mm256_div_pd(_mm256_sub_pd(target, _mm256_loadu_pd(held + i)), l),
+                                       _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256d d = _mm256_mul_pd(lots, l);
+        __m256d notional = _mm256_mul_pd(_mm256_andnot_pd(vsign, d), p);
+        __m256d keep = _mm256_and_pd(_mm256_cmp_pd(p, vzero, _CMP_GT_OQ),
+                                     _mm256_cmp_pd(notional, vthreshold, _CMP_GE_OQ));
+        _mm256_storeu_pd(delta + i, _mm256_and_pd(d, keep));
+    }
+#endif
+    for (; i < n; ++i) {
+        double d = 0.0;
+        if (price[i] > 0.0) {
+            d = std::trunc((weights[i] * equity / price[i] - held[i]) / lot[i]) * lot[i];
+            if (std::abs(d) * price[i] < threshold) d = 0.0;
+        }
+        delta[i] = d;
+    }
+
+    // Sells first so their proceeds are there for the buys
+    for (size_t j = 0; j < n; ++j) {
+        if (delta[j] < 0.0) {
+            orders.push_back({symbols_[j], OrderSide::SELL, -delta[j]});
+        }
+    }
+    for (size_t j = 0; j < n; ++j) {
+        if (delta[j] > 0.0) {
+            orders.push_back({symbols_[j], OrderSide::BUY, delta[j]});
+        }
+    }
+}
+
+} // namespace strategy
+} // namespace quantflow
@@ -0,0 +1,228 @@
+#include "quantflow/utils/mapped_file.hpp"
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace quantflow {
+namespace utils {
+
+#ifdef _WIN32
+
+namespace {
+
+bool set_file_size(HANDLE file, size_t size) {
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    return ::SetFilePointerEx(file, end, nullptr, FILE_BEGIN) && ::SetEndOfFile(file);
+}
+
+} // namespace
+
+size_t MappedFile::page_size() {
+    // Views start on allocation-granularity boundaries, not just pages
+    static const size_t size = [] {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwAllocationGranularity);
+    }();
+    return size;
+}
+
+MappedFile::MappedFile(const std::string& path, size_t max_size)
+    : path_(path), file_size_(0), reserved_(max_size), mapped_(0), base_(nullptr),
+      file_(nullptr), mapping_(nullptr) {
+    HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open mapped file: " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(file, &size)) {
+        ::CloseHandle(file);
+        throw std::runtime_error("Failed to stat mapped file: " + path);
+    }
+    file_ = file;
+    file_size_ = static_cast<size_t>(size.QuadPart);
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    ::CloseHandle(static_cast<HANDLE>(file_));
+}
+
+void MappedFile::unmap() {
+    if (base_) {
+        ::UnmapViewOfFile(base_);
+        base_ = nullptr;
+    }
+    if (mapping_) {
+        ::CloseHandle(static_cast<HANDLE>(mapping_));
+        mapping_ = nullptr;
+    }
+    mapped_ = 0;
+}
+
+void MappedFile::resize(size_t size) {
+    if (size > reserved_) {
+        throw std::runtime_error("Mapped file exceeds its maximum size: " + path_);
+    }
+
+    // A view fixes the mapping's size, so growing maps the file afresh
+    unmap();
+    HANDLE file = static_cast<HANDLE>(file_);
+    if (!set_file_size(file, size)) {
+        throw std::runtime_error("Failed to size mapped file: " + path_);
+    }
+    file_size_ = size;
+
+    HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                         static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                         static_cast<DWORD>(size & 0xFFFFFFFFu), nullptr);
+    if (!mapping) {
+        throw std::runtime_error("Failed to map file: " + path_);
+    }
+    void* view = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        ::CloseHandle(mapping);
+        throw std::runtime_error("Failed to map file: " + path_);
+    }
+    mapping_ = mapping;
+    base_ = static_cast<char*>(view);
+    mapped_ = size;
+}
+
+bool MappedFile::truncate(size_t size) {
+    unmap();
+    HANDLE file = static_cast<HANDLE>(file_);
+    if (!set_file_size(file, size) || !::FlushFileBuffers(file)) {
+        return false;
+    }
+    file_size_ = size;
+    return true;
+}
+
+int MappedFile::flush(size_t offset, size_t length) {
+    // FlushViewOfFile only starts the writeback; FlushFileBuffers waits
+    if (!::FlushViewOfFile(base_ + offset, length) ||
+        !::FlushFileBuffers(static_cast<HANDLE>(file_))) {
+        return static_cast<int>(::GetLastError());
+    }
+    return 0;
+}
+
+std::string MappedFile::describe(int error) {
+    char buffer[256];
+    DWORD length = ::FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+                                    nullptr, static_cast<DWORD>(error), 0,
+                                    buffer, sizeof(buffer), nullptr);
+    while (length > 0 && (buffer[length - 1] == '\r' || buffer[length - 1] == '\n')) {
+        --length;
+    }
+    return length > 0 ? std::string(buffer, length) : "error " + std::to_string(error);
+}
+
+#else
+
+size_t MappedFile::page_size() {
+    // msync needs a page-aligned address, and pages are not 4K everywhere
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+MappedFile::MappedFile(const std::string& path, size_t max_size)
+    : path_(path), file_size_(0), reserved_(0), mapped_(0), base_(nullptr), fd_(-1) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open mapped file: " + path);
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        ::close(fd_);
+        throw std::runtime_error("Failed to stat mapped file: " + path);
+    }
+    file_size_ = static_cast<size_t>(st.st_size);
+
+    reserved_ = (max_size + page_size() - 1) & ~(page_size() - 1);
+    void* base = ::mmap(nullptr, reserved_, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+        ::close(fd_);
+        throw std::runtime_error("Failed to reserve address space for mapped file: " + path);
+    }
+    base_ = static_cast<char*>(base);
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+    ::close(fd_);
+}
+
+void MappedFile::unmap() {
+    if (base_) {
+        ::munmap(base_, reserved_);
+        base_ = nullptr;
+    }
+    mapped_ = 0;
+}
+
+// The pages below the old size stay mapped, so another thread can msync
+// them while this runs
+void MappedFile::resize(size_t size) {
+    if (size > reserved_) {
+        throw std::runtime_error("Mapped file exceeds its maximum size: " + path_);
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        throw std::runtime_error("Failed to size mapped file: " + path_);
+    }
+    file_size_ = size;
+
+    if (size > mapped_) {
+        void* base = ::mmap(base_ + mapped_, size - mapped_, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_FIXED, fd_, static_cast<off_t>(mapped_));
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("Failed to map file: " + path_);
+        }
+    }
+    mapped_ = size;
+}
+
+bool MappedFile::truncate(size_t size) {
+    // The reservation is kept; resize() maps over it again from the start
+    mapped_ = 0;
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0 || ::fsync(fd_) != 0) {
+        return false;
+    }
+    file_size_ = size;
+    return true;
+}
+
+int MappedFile::flush(size_t offset, size_t length) {
+    return ::msync(base_ + offset, length, MS_SYNC) == 0 ? 0 : errno;
+}
+
+std::string MappedFile::describe(int error) {
+    return std::strerror(error);
+}
+
+#endif
+
+} // namespace utils
+} // namespace quantflow